@@ -12,19 +12,23 @@
  *   - Can be converted into an array
  *
  * Implementation:
- *   - Uses nodes with left and right pointers to children nodes
+ *   - A SortedTree<BSTData, BSTDataCompare> does the work, see sortedTree.h
+ *   - BSTDataCompare orders with the virtual operator< and operator== of
+ *     BSTData, so any BSTData subclass can be stored. Code that knows the
+ *     exact type it stores should use SortedTree with its own comparator
  *   - When converted to an array, stored inorder
+ *   - Optionally self-balancing (AVL) and optionally arena-backed, see
+ *     TreeOption
  *
  */
 
 #include "BSTree.h"
 #include "BSTData.h"
+#include "outputSink.h"
 #include <iostream>
 
 using namespace std;
 
-const int ARRAY_SIZE = 100;
-
 //--------------------------------------------------------------------------
 /** Constructor
  * default constructor
@@ -33,7 +37,18 @@ const int ARRAY_SIZE = 100;
  * @pre None.
  * @post BSTree object exists. root is instantiated to NULLPTR
  */
-BSTree::BSTree() { root = nullptr; }
+BSTree::BSTree() : tree(TREE_PLAIN) {}
+
+//--------------------------------------------------------------------------
+/** Constructor
+ * constructor with options
+ *
+ * Creates an empty BSTree object that inserts using the given options.
+ * @param options TreeOption values combined with |
+ * @pre None.
+ * @post BSTree object exists. root is instantiated to NULLPTR
+ */
+BSTree::BSTree(int options) : tree(options) {}
 
 //--------------------------------------------------------------------------
 /** Destructor
@@ -44,7 +59,7 @@ BSTree::BSTree() { root = nullptr; }
  * @pre BSTree object exists
  * @post BSTree is deleted from memory
  */
-BSTree::~BSTree() { makeEmpty(); }
+BSTree::~BSTree() {}
 
 //--------------------------------------------------------------------------
 /** makeEmpty
@@ -54,33 +69,7 @@ BSTree::~BSTree() { makeEmpty(); }
  * @pre None.
  * @post The tree is empty.
  */
-void BSTree::makeEmpty()
-{
-   makeEmptyHelper(root);
-   root = nullptr;
-}
-
-//--------------------------------------------------------------------------
-/** makeEmptyHelper
- * Helper for makeEmpty()A
- *
- * Recursively traverses the tree. Deleting each node in postOrder order.
- * @param current the current node we are looking at
- * @pre None.
- * @post The tree is empty.
- */
-void BSTree::makeEmptyHelper(Node* current)
-{
-   if (current == nullptr) {
-      return;
-   }
-   makeEmptyHelper(current->left);
-   makeEmptyHelper(current->right);
-
-   delete current->data;
-
-   delete current;
-}
+void BSTree::makeEmpty() { tree.makeEmpty(); }
 
 //--------------------------------------------------------------------------
 /** isEmpty
@@ -92,7 +81,7 @@ void BSTree::makeEmptyHelper(Node* current)
  * @post None. BSTree is unchanged.
  * @return bool that is true if BSTree is empty, false otherwise.
  */
-bool BSTree::isEmpty() const { return root == nullptr; }
+bool BSTree::isEmpty() const { return tree.isEmpty(); }
 
 //--------------------------------------------------------------------------
 /** insert
@@ -107,47 +96,7 @@ bool BSTree::isEmpty() const { return root == nullptr; }
  * @return True if datanode was inserted, false if the data already exists in
  * the tree
  */
-bool BSTree::insert(BSTData* dataptr)
-{
-   Node* ptr = new Node; // exception is thrown if memory is not allocated
-
-   ptr->data = dataptr;
-
-   ptr->left = ptr->right = nullptr;
-   if (isEmpty()) {
-      root = ptr;
-   } else {
-      Node* current = root;
-      bool inserted = false;
-
-      // if item is less than current item, insert in left subtree,
-      // otherwise insert in right subtree
-      while (!inserted) {
-         if (*ptr->data < *current->data) {
-            if (current->left == nullptr) { // at leaf, insert left
-               current->left = ptr;
-               dataptr = nullptr;
-               inserted = true;
-            } else
-               current = current->left; // one step left
-         } else if (*ptr->data == *current->data) {
-
-            delete ptr;
-
-            return false;
-         } else {
-            if (current->right == nullptr) { // at leaf, insert right
-               current->right = ptr;
-               dataptr = nullptr;
-               inserted = true;
-            } else
-               current = current->right; // one step right
-         }
-      }
-   }
-
-   return true;
-}
+bool BSTree::insert(BSTData* dataptr) { return tree.insert(dataptr); }
 
 //--------------------------------------------------------------------------
 /** operator<<
@@ -163,23 +112,14 @@ bool BSTree::insert(BSTData* dataptr)
  */
 ostream& operator<<(ostream& os, const BSTree& BSTree)
 {
-
-   BSTree.inorderHelper(os, BSTree.root);
+   BSTree.tree.inorder([&os](const BSTData* data) {
+      data->display(os);
+      os << '\n';
+   });
 
    return os;
 }
 
-void BSTree::inorderHelper(ostream& os, const Node* node) const
-{
-   if (node == nullptr) {
-      return;
-   }
-   inorderHelper(os, node->left);
-   node->data->display(os);
-   cout << endl;
-   inorderHelper(os, node->right);
-}
-
 //--------------------------------------------------------------------------
 /** retrieve
  * Retrieve Node
@@ -204,143 +144,60 @@ void BSTree::inorderHelper(ostream& os, const Node* node) const
  */
 bool BSTree::retrieve(const BSTData& nodeToFind, BSTData*& foundNode) const
 {
-   const Node* found = findNode(nodeToFind, root);
-   if (found == nullptr) {
-      return false;
-   }
-   foundNode = found->data;
-   return true;
-}
-
-//--------------------------------------------------------------------------
-/** findNode
- * Find node in tree
- * Traverse tree recursively, looking for the node.
- *
- * @param nodeToFind the BSTData to find in the tree
- * @param current the current node we are looking at in the tree
- * @pre nodeToFind should be comparable to the BSTData in the tree
- * @post None. Tree and nodes are unchanged.
- * @return the node we were looking for. return nullptr if not found.
- */
-const BSTree::Node* BSTree::findNode(const BSTData& nodeToFind,
-                                     const Node* current) const
-{
-   if (current == nullptr) {
-      return nullptr;
-   }
-   if (*current->data == nodeToFind) {
-      return current;
-   }
-
-   const Node* temp = findNode(nodeToFind, current->left);
-   if (temp == nullptr) {
-      temp = findNode(nodeToFind, current->right);
-   }
-
-   return temp;
+   return tree.retrieve(nodeToFind, foundNode);
 }
 
 //--------------------------------------------------------------------------
 /** displaySideways
  * Display the tree sideways
  *
- * prints the tree directly to cout as if it had been rotated 90 degrees.
+ * prints the tree to output() as if it had been rotated 90 degrees.
  * @pre None.
- * @post None. the tree is unchanged. cout (the ostream object) will
+ * @post None. the tree is unchanged. output() (the ostream object) will
  * be used to display output during the function.
  */
-void BSTree::displaySideways() const { sidewaysHelper(root, 0); }
-
-//--------------------------------------------------------------------------
-/** sidwaysHelper
- * Print the tree sideways
- *
- * A helper function called by displaySideways that traverses the tree and
- * prints data from nodes in a way taht makes the tree look like it was
- * rotated 90 degrees.
- * @param current The current node
- * @param level the current level
- * @pre None.
- * @post cout may or may not have a new value printed to it
- */
-void BSTree::sidewaysHelper(Node* current, int level) const
+void BSTree::displaySideways() const
 {
-   if (current != nullptr) {
-      level++;
-      sidewaysHelper(current->right, level);
-
+   ostream& os = output();
+   tree.sideways([&os](const BSTData* data, int level) {
       // indent for readability, same number of spaces per depth level
       for (int i = level; i >= 0; i--) {
-         cout << "      ";
-      }
-      if (current != nullptr) {
-         current->data->display(cout); // display information of object
-         cout << endl;
+         os << "      ";
       }
-      sidewaysHelper(current->left, level);
-   }
+      data->display(os); // display information of object
+      os << '\n';
+   });
 }
 
 //--------------------------------------------------------------------------
 /** arrayToBSTree
  * turn array into BSTree
  *
- * Builds a balanced bSTree from a sorted array of BSTData*. Leaves the
- * array with nullptrs.
+ * Builds a perfectly balanced BSTree from a sorted array of BSTData* in
+ * linear time. Leaves the array with nullptrs. There is no limit on the
+ * number of items.
  * @param arr An array of BSTData*
- * @pre must pass an array of BSTData*
+ * @param count number of items in arr
+ * @pre arr holds count BSTData* sorted by operator< with no duplicates
  * @post The current BSTree now contains the BSTDatas from the array,
  * balanced. The old tree was deleted.
  */
-void BSTree::arrayToBSTree(BSTData* arr[])
+void BSTree::arrayToBSTree(BSTData* arr[], int count)
 {
-   makeEmpty();
-   int count = 0;
-   while (arr[count] != nullptr && count < 100) {
-      count++;
-   }
-
-   arrayToBSTreeHelper(arr, root, 0, count - 1);
+   tree.arrayToTree(arr, count);
 }
 
 //--------------------------------------------------------------------------
-/** arrayToBSTreeHelper
- * Helper function for arrayToBSTree
+/** bstreeToArray
+ * turn BSTree into array
  *
- * Builds a BST by taking the center of the array as a root, then makes it's
- * left and right subtrees halfway from mid to end and halfway from mid to
- * start and etcetra. Like a binary search, but where N nodes are reached. N
- * being the llength of the array with good values. The array is emptied and
- * the current tree is replaced by the balanced tree from this array
- * @param arr An array of BSTData*
- * @param current The current node we are building
- * @param start the starting index for this subtree
- * @param end the ending index for this subtree
- * @pre start > 0. end < size of arr. arr should point to BSTData objects in
- * free store
- * @post all arr pointers are nullptr. The tree is now balanced and contains
- * all nodes from the array
+ * Moves the data of the tree into arr in sorted (inorder) order and empties
+ * the tree. The data is not deleted, the caller now owns it.
+ * @param arr An array with room for getSize() BSTData*
+ * @pre arr is at least getSize() long
+ * @post arr holds the data in sorted order. The tree is empty.
  */
-void BSTree::arrayToBSTreeHelper(BSTData* arr[], Node*& current, int start,
-                                 int end)
-{
-   if (end < start || start > end) {
-      return;
-   }
-   int currentIndex = (start + end) / 2;
-   if (arr[currentIndex] == nullptr) {
-      return;
-   }
-   current = new Node();
-
-   current->data = arr[currentIndex];
-   arr[currentIndex] = nullptr;
-   current->left = nullptr;
-   current->right = nullptr;
-   arrayToBSTreeHelper(arr, current->left, start, currentIndex - 1);
-   arrayToBSTreeHelper(arr, current->right, currentIndex + 1, end);
-}
+void BSTree::bstreeToArray(BSTData* arr[]) { tree.treeToArray(arr); }
 
 //--------------------------------------------------------------------------
 /** getRoot()
@@ -351,4 +208,82 @@ void BSTree::arrayToBSTreeHelper(BSTData* arr[], Node*& current, int start,
  * @post None.
  * @return const BSTData*
  */
-const BSTData* BSTree::getRoot() const { return root->data; }
\ No newline at end of file
+const BSTData* BSTree::getRoot() const { return tree.getRoot(); }
+
+//--------------------------------------------------------------------------
+/** getLastComparisons()
+ * Comparisons made by the last retrieve
+ *
+ * Returns how many nodes the most recent call to retrieve compared against
+ * before it found the node or ran off the bottom of the tree
+ * @pre None.
+ * @post None.
+ * @return number of comparisons made by the last retrieve
+ */
+int BSTree::getLastComparisons() const
+{
+   return tree.getLastComparisons();
+}
+
+//--------------------------------------------------------------------------
+/** getTotalComparisons()
+ * Comparisons made by all retrieves
+ *
+ * Returns the running total of nodes compared against by every call to
+ * retrieve on this tree. Divide by getRetrieveCount() for the average cost
+ * of a lookup.
+ * @pre None.
+ * @post None.
+ * @return total number of comparisons made by retrieve
+ */
+long long BSTree::getTotalComparisons() const
+{
+   return tree.getTotalComparisons();
+}
+
+//--------------------------------------------------------------------------
+/** getRetrieveCount()
+ * Number of retrieves
+ *
+ * Returns how many times retrieve has been called on this tree
+ * @pre None.
+ * @post None.
+ * @return number of calls to retrieve
+ */
+long long BSTree::getRetrieveCount() const
+{
+   return tree.getRetrieveCount();
+}
+
+//--------------------------------------------------------------------------
+/** getHeight()
+ * Height of the tree
+ *
+ * Returns the number of nodes on the longest path from the root down to a
+ * leaf. An empty tree has height 0.
+ * @pre None.
+ * @post None.
+ * @return height of the tree
+ */
+int BSTree::getHeight() const { return tree.getHeight(); }
+
+//--------------------------------------------------------------------------
+/** getSize()
+ * Size of the tree
+ *
+ * Returns the number of nodes in the tree
+ * @pre None.
+ * @post None.
+ * @return number of nodes
+ */
+int BSTree::getSize() const { return tree.getSize(); }
+
+//--------------------------------------------------------------------------
+/** isBalanced()
+ * Is the tree self-balancing?
+ *
+ * @pre None.
+ * @post None.
+ * @return true if this tree was created with TREE_BALANCED
+ */
+bool BSTree::isBalanced() const { return tree.isBalanced(); }
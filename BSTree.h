@@ -12,8 +12,13 @@
  *   - Can be converted into an array
  *
  * Implementation:
- *   - Uses nodes with left and right pointers to children nodes
+ *   - A SortedTree<BSTData, BSTDataCompare> does the work, see sortedTree.h
+ *   - BSTDataCompare orders with the virtual operator< and operator== of
+ *     BSTData, so any BSTData subclass can be stored. Code that knows the
+ *     exact type it stores should use SortedTree with its own comparator
  *   - When converted to an array, stored inorder
+ *   - Optionally self-balancing (AVL) and optionally arena-backed, see
+ *     TreeOption
  *
  */
 
@@ -21,9 +26,27 @@
 #define BSTREE_H
 
 #include "BSTData.h"
+#include "sortedTree.h"
 #include <iostream>
 using namespace std;
 
+//-----------------------------------------------------------------------------
+/** BSTDataCompare
+ *
+ * Three-way comparison of two BSTData through their virtual operators, for
+ * SortedTree. Tests < first and then ==, like the original insert did.
+ */
+//-----------------------------------------------------------------------------
+struct BSTDataCompare {
+   int operator()(const BSTData& lhs, const BSTData& rhs) const
+   {
+      if (lhs < rhs) {
+         return -1;
+      }
+      return lhs == rhs ? 0 : 1;
+   }
+};
+
 //-----------------------------------------------------------------------------
 /** BSTree Class
  *
@@ -63,6 +86,17 @@ public:
     */
    BSTree();
 
+   //--------------------------------------------------------------------------
+   /** Constructor
+    * constructor with options
+    *
+    * Creates an empty BSTree object that inserts using the given options.
+    * @param options TreeOption values combined with |
+    * @pre None.
+    * @post BSTree object exists. root is instantiated to NULLPTR
+    */
+   explicit BSTree(int options);
+
    //--------------------------------------------------------------------------
    /** Destructor
     * Destructor
@@ -139,9 +173,9 @@ public:
    /** displaySideways
     * Display the tree sideways
     *
-    * prints the tree directly to cout as if it had been rotated 90 degrees.
+    * prints the tree to output() as if it had been rotated 90 degrees.
     * @pre None.
-    * @post None. the tree is unchanged. cout (the ostream object) will
+    * @post None. the tree is unchanged. output() (the ostream object) will
     * be used to display output during the function.
     */
    void displaySideways() const;
@@ -150,14 +184,28 @@ public:
    /** arrayToBSTree
     * turn array into BSTree
     *
-    * Builds a balanced bSTree from a sorted array of BSTData*. Leaves the
-    * array with nullptrs.
+    * Builds a perfectly balanced BSTree from a sorted array of BSTData* in
+    * linear time. Leaves the array with nullptrs. There is no limit on the
+    * number of items.
     * @param arr An array of BSTData*
-    * @pre must pass an array of BSTData*
+    * @param count number of items in arr
+    * @pre arr holds count BSTData* sorted by operator< with no duplicates
     * @post The current BSTree now contains the BSTDatas from the array,
     * balanced. The old tree was deleted.
     */
-   void arrayToBSTree(BSTData* arr[]);
+   void arrayToBSTree(BSTData* arr[], int count);
+
+   //--------------------------------------------------------------------------
+   /** bstreeToArray
+    * turn BSTree into array
+    *
+    * Moves the data of the tree into arr in sorted (inorder) order and empties
+    * the tree. The data is not deleted, the caller now owns it.
+    * @param arr An array with room for getSize() BSTData*
+    * @pre arr is at least getSize() long
+    * @post arr holds the data in sorted order. The tree is empty.
+    */
+   void bstreeToArray(BSTData* arr[]);
 
    //--------------------------------------------------------------------------
    /** getRoot()
@@ -170,85 +218,78 @@ public:
     */
    const BSTData* getRoot() const;
 
-private:
    //--------------------------------------------------------------------------
-   /** Node struct
+   /** getLastComparisons()
+    * Comparisons made by the last retrieve
     *
-    * A BSTree is made up of nodes. These nodes point to left and right nodes.
-    * They point to dataNodes that represent the data inside ofthem
+    * Returns how many nodes the most recent call to retrieve compared against
+    * before it found the node or ran off the bottom of the tree
+    * @pre None.
+    * @post None.
+    * @return number of comparisons made by the last retrieve
     */
-   struct Node {
-      // The data within a node
-      BSTData* data;
-      // left subtree pointer
-      Node* left;
-      // right subtree pointer
-      Node* right;
-   };
+   int getLastComparisons() const;
 
-   // the root of the tree
-   Node* root;
+   //--------------------------------------------------------------------------
+   /** getTotalComparisons()
+    * Comparisons made by all retrieves
+    *
+    * Returns the running total of nodes compared against by every call to
+    * retrieve on this tree. Divide by getRetrieveCount() for the average cost
+    * of a lookup.
+    * @pre None.
+    * @post None.
+    * @return total number of comparisons made by retrieve
+    */
+   long long getTotalComparisons() const;
 
    //--------------------------------------------------------------------------
-   /** sidwaysHelper
-    * Print the tree sideways
+   /** getRetrieveCount()
+    * Number of retrieves
     *
-    * A helper function called by displaySideways that traverses the tree and
-    * prints data from nodes in a way taht makes the tree look like it was
-    * rotated 90 degrees.
-    * @param current The current node
-    * @param level the current level
+    * Returns how many times retrieve has been called on this tree
     * @pre None.
-    * @post cout may or may not have a new value printed to it
+    * @post None.
+    * @return number of calls to retrieve
     */
-   void sidewaysHelper(Node* current, int level) const;
+   long long getRetrieveCount() const;
 
    //--------------------------------------------------------------------------
-   /** makeEmptyHelper
-    * Helper for makeEmpty()
+   /** getHeight()
+    * Height of the tree
     *
-    * Recursively traverses the tree. Deleting each node in postOrder order.
-    * @param current the current node we are looking at
+    * Returns the number of nodes on the longest path from the root down to a
+    * leaf. An empty tree has height 0.
     * @pre None.
-    * @post The tree is empty.
+    * @post None.
+    * @return height of the tree
     */
-   void makeEmptyHelper(Node* current);
+   int getHeight() const;
 
    //--------------------------------------------------------------------------
-   /** findNode
-    * Find node in tree
-    * Traverse tree recursively, looking for the node.
+   /** getSize()
+    * Size of the tree
     *
-    * @param nodeToFind the BSTData to find in the tree
-    * @param current the current node we are looking at in the tree
-    * @pre nodeToFind should be comparable to the BSTData in the tree
-    * @post None. Tree and nodes are unchanged.
-    * @return the node we were looking for. return nullptr if not found.
+    * Returns the number of nodes in the tree
+    * @pre None.
+    * @post None.
+    * @return number of nodes
     */
-   const Node* findNode(const BSTData& nodeToFind, const Node* current) const;
+   int getSize() const;
 
    //--------------------------------------------------------------------------
-   /** arrayToBSTreeHelper
-    * Helper function for arrayToBSTree
+   /** isBalanced()
+    * Is the tree self-balancing?
     *
-    * Builds a BST by taking the center of the array as a root, then makes it's
-    * left and right subtrees halfway from mid to end and halfway from mid to
-    * start and etcetra. Like a binary search, but where N nodes are reached. N
-    * being the llength of the array with good values. The array is emptied and
-    * the current tree is replaced by the balanced tree from this array
-    * @param arr An array of BSTData*
-    * @param current The current node we are building
-    * @param start the starting index for this subtree
-    * @param end the ending index for this subtree
-    * @pre start > 0. end < size of arr. arr should point to BSTData objects in
-    * free store
-    * @post all arr pointers are nullptr. The tree is now balanced and contains
-    * all nodes from the array
-    */
-   void arrayToBSTreeHelper(BSTData* arr[], Node*& current, int start,
-                            int end);
-
-   void inorderHelper(ostream& os, const Node* node) const;
+    * @pre None.
+    * @post None.
+    * @return true if this tree was created with TREE_BALANCED
+    */
+   bool isBalanced() const;
+
+private:
+   // the tree itself, ordered through the virtual comparison operators
+   SortedTree<BSTData, BSTDataCompare> tree;
 };
 
-#endif
\ No newline at end of file
+#endif
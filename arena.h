@@ -0,0 +1,180 @@
+/** @file arena.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - An Arena hands out storage for many objects of one type and gives it
+ *     all back at once
+ *   - Objects handed out one after another sit next to each other in memory
+ *   - Can visit every object it has handed out, in the order handed out
+ *
+ * Implementation:
+ *   - Storage is kept in blocks. Each new block is twice the size of the
+ *     last one, up to MAX_BLOCK objects, so a small arena stays small
+ *   - allocate() only bumps an index, there is no per-object malloc
+ *   - Only the most recent allocation can be handed back early (unallocate)
+ *   - The arena never runs constructors or destructors. The caller builds
+ *     objects in the storage with placement new and destroys them if needed
+ *     before releaseAll()
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <new>
+#include <vector>
+
+using namespace std;
+
+template <class T>
+class Arena
+{
+public:
+   // -------------------------------------------------------------------------
+   /** Arena()
+    * Default Constructor
+    *
+    * Creates an empty arena. No storage is allocated until the first call
+    * to allocate().
+    * @pre None.
+    * @post Arena exists and is empty
+    */
+   Arena()
+   {
+      used = 0;
+      count = 0;
+   }
+
+   // -------------------------------------------------------------------------
+   /** ~Arena()
+    * Destructor
+    *
+    * Frees every block. Destructors of the objects are not run.
+    * @pre None.
+    * @post All storage is returned to the system
+    */
+   ~Arena() { releaseAll(); }
+
+   // no copies, the arena owns its blocks
+   Arena(const Arena&) = delete;
+   Arena& operator=(const Arena&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** allocate()
+    * Get storage for one object
+    *
+    * Returns uninitialized storage big enough for one T. A new block is only
+    * allocated when the current one is full.
+    * @pre None.
+    * @post count is one higher
+    * @return pointer to storage for one T
+    */
+   void* allocate()
+   {
+      if (blocks.empty() || used == blocks.back().capacity) {
+         int capacity = MIN_BLOCK;
+         if (!blocks.empty() && blocks.back().capacity < MAX_BLOCK) {
+            capacity = blocks.back().capacity * 2;
+         } else if (!blocks.empty()) {
+            capacity = MAX_BLOCK;
+         }
+         Block block;
+         block.slots = static_cast<T*>(::operator new(sizeof(T) * capacity));
+         block.capacity = capacity;
+         blocks.push_back(block);
+         used = 0;
+      }
+      count++;
+      return blocks.back().slots + used++;
+   }
+
+   // -------------------------------------------------------------------------
+   /** unallocate()
+    * Hand back the last allocation
+    *
+    * Gives back the storage returned by the most recent allocate() so it is
+    * handed out again next time.
+    * @param slot storage returned by the most recent allocate()
+    * @pre slot is the most recent allocation and nothing was allocated since
+    * @post count is one lower
+    */
+   void unallocate(void* slot)
+   {
+      if (!blocks.empty() && used > 0 &&
+          slot == blocks.back().slots + used - 1) {
+         used--;
+         count--;
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   /** releaseAll()
+    * Free everything
+    *
+    * Returns every block to the system in one pass. Destructors of the
+    * objects are not run.
+    * @pre None.
+    * @post Arena is empty
+    */
+   void releaseAll()
+   {
+      for (Block& block : blocks) {
+         ::operator delete(block.slots);
+      }
+      blocks.clear();
+      used = 0;
+      count = 0;
+   }
+
+   // -------------------------------------------------------------------------
+   /** forEach()
+    * Visit every object
+    *
+    * Calls visit with a T* for every allocation still held, in the order
+    * they were handed out. Walks the blocks front to back.
+    * @param visit function or lambda taking a T*
+    * @pre every allocation holds a constructed T
+    * @post None.
+    */
+   template <class Visit>
+   void forEach(Visit visit)
+   {
+      for (size_t i = 0; i < blocks.size(); i++) {
+         int end = i + 1 == blocks.size() ? used : blocks[i].capacity;
+         for (int j = 0; j < end; j++) {
+            visit(blocks[i].slots + j);
+         }
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   /** getCount()
+    * Number of allocations held
+    *
+    * @pre None.
+    * @post None.
+    * @return number of objects handed out and not yet released
+    */
+   int getCount() const { return count; }
+
+private:
+   // smallest and largest number of objects in one block
+   static const int MIN_BLOCK = 64;
+   static const int MAX_BLOCK = 4096;
+
+   // one contiguous run of storage
+   struct Block {
+      T* slots;
+      int capacity;
+   };
+
+   // every block, the last one is the one being filled
+   vector<Block> blocks;
+
+   // slots handed out from the last block
+   int used;
+
+   // slots handed out in total
+   int count;
+};
+
+#endif
@@ -0,0 +1,127 @@
+/** @file allocationBench.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Heap allocations made while loading the catalog and while running
+ *     commands, per book line and per command
+ *   - Broken down by command type, so a change to one command's path shows
+ *     up on its own line
+ *
+ * Implementation:
+ *   - Counts allocations with the operator new of benchCommon.h
+ *   - For each command type, builds a fresh library from the book and
+ *     patron files and runs only the commands of that type, in file order.
+ *     Then builds one more library and runs the whole command file
+ *   - Command and error output goes to a NullSink, which never allocates
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/allocationBench.cpp \
+ *       $(ls *.cpp | grep -v main.cpp) -o allocationBench
+ *   ./allocationBench [books] [patrons] [commands]
+ */
+
+#define COUNT_ALLOCATIONS
+#include "benchCommon.h"
+
+#include "library.h"
+#include "libraryBuilder.h"
+#include "lineSource.h"
+#include "outputSink.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+/** buildLibrary()
+ * Build a library from the text files
+ *
+ * @param books name of the book file
+ * @param patrons name of the patron file
+ * @return the new library
+ */
+Library* buildLibrary(const string& books, const string& patrons)
+{
+   LineSource bookLines(books);
+   LineSource patronLines(patrons);
+   LibraryBuilder builder;
+   return builder.createLibrary(bookLines, patronLines);
+}
+
+// -----------------------------------------------------------------------------
+/** runCommands()
+ * Allocations made running commands
+ *
+ * @param books name of the book file
+ * @param patrons name of the patron file
+ * @param commands the command lines to run
+ * @return allocations made while the commands ran
+ */
+long long runCommands(const string& books, const string& patrons,
+                      const string& commands)
+{
+   Library* library = buildLibrary(books, patrons);
+   istringstream lines(commands);
+   long long before = allocations;
+   library->processCommands(lines);
+   long long made = allocations - before;
+   delete library;
+   return made;
+}
+
+int main(int argc, char* argv[])
+{
+   string books = argc > 1 ? argv[1] : "data4books.txt";
+   string patrons = argc > 2 ? argv[2] : "data4patrons.txt";
+   string commands = argc > 3 ? argv[3] : "data4commands.txt";
+
+   NullSink nullSink;
+   ostream nowhere(&nullSink);
+   OutputScope quiet(nowhere);
+
+   // the command lines, all of them and grouped by type code
+   string all;
+   map<char, string> byType;
+   map<char, long long> countByType;
+   long long commandCount = 0;
+   ifstream file(commands);
+   string line;
+   while (getline(file, line)) {
+      all += line + '\n';
+      char type = line.empty() ? ' ' : line[0];
+      byType[type] += line + '\n';
+      countByType[type]++;
+      commandCount++;
+   }
+
+   long long bookLines = 0;
+   ifstream bookFile(books);
+   while (getline(bookFile, line)) {
+      bookLines++;
+   }
+
+   long long before = allocations;
+   delete buildLibrary(books, patrons);
+   long long loadAllocations = allocations - before;
+
+   printf("%-8s %10s %12s %10s\n", "", "lines", "allocations", "per line");
+   printf("%-8s %10lld %12lld %10.2f\n", "load", bookLines, loadAllocations,
+          bookLines > 0 ? (double)loadAllocations / bookLines : 0.0);
+   for (const auto& group : byType) {
+      long long made = runCommands(books, patrons, group.second);
+      string name = string("cmd ") + group.first;
+      printf("%-8s %10lld %12lld %10.2f\n", name.c_str(),
+             countByType[group.first], made,
+             (double)made / countByType[group.first]);
+   }
+   long long made = runCommands(books, patrons, all);
+   printf("%-8s %10lld %12lld %10.2f\n", "all", commandCount, made,
+          commandCount > 0 ? (double)made / commandCount : 0.0);
+   return 0;
+}
@@ -0,0 +1,111 @@
+/** @file benchCommon.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - What the benchmarks share: a count of heap allocations, and the
+ *     generated catalog they run on
+ *
+ * Implementation:
+ *   - Each benchmark is one file, so this header is included once per
+ *     program. The counting operator new is only defined when
+ *     COUNT_ALLOCATIONS is defined before the include, so benchmarks that
+ *     do not count keep the normal allocator
+ *   - Book i of the catalog is fiction when i % 10 < 6, children's when
+ *     i % 10 < 9 and a periodical otherwise. Authors repeat every 97 books
+ *     so the title decides some comparisons, the way several books by one
+ *     author do in a real catalog. Periodicals are monthly issues, twelve
+ *     to a journal
+ */
+
+#ifndef BENCHCOMMON_H
+#define BENCHCOMMON_H
+
+#include "constants.h"
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace std;
+
+#ifdef COUNT_ALLOCATIONS
+// calls to operator new since the program started
+static long long allocations = 0;
+
+void* operator new(size_t size)
+{
+   allocations++;
+   void* memory = malloc(size == 0 ? 1 : size);
+   if (memory == nullptr) {
+      throw bad_alloc();
+   }
+   return memory;
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+#endif
+
+// -----------------------------------------------------------------------------
+/** bookTypeOf()
+ * Type of book number i
+ *
+ * @param i number of the book
+ * @return FICTION_CODE, CHILDREN_CODE or PERIODICAL_CODE, six, three and one
+ * in ten
+ */
+inline char bookTypeOf(int i)
+{
+   if (i % 10 < 6) {
+      return FICTION_CODE;
+   }
+   return i % 10 < 9 ? CHILDREN_CODE : PERIODICAL_CODE;
+}
+
+// -----------------------------------------------------------------------------
+/** makeBookLine()
+ * Book file line of book number i
+ *
+ * @param i number of the book
+ * @param type type code the book is made as
+ * @return the line, without a newline
+ */
+inline string makeBookLine(int i, char type)
+{
+   string year = to_string(1900 + i % 120);
+   if (type == PERIODICAL_CODE) {
+      return string(1, type) + " Journal " + to_string(i / 12) + ", " +
+             to_string(1 + i % 12) + " " + year;
+   }
+   return string(1, type) + " Author " + to_string(i % 97) +
+          ", Title number " + to_string(i) + ", " + year;
+}
+
+inline string makeBookLine(int i) { return makeBookLine(i, bookTypeOf(i)); }
+
+// -----------------------------------------------------------------------------
+/** makeBookKey()
+ * Book number i as a command names it
+ *
+ * @param i number of the book
+ * @param type type code the book is made as
+ * @return the book part of a checkout or return line, hardcover
+ */
+inline string makeBookKey(int i, char type)
+{
+   string author = "Author " + to_string(i % 97);
+   string title = "Title number " + to_string(i);
+   switch (type) {
+   case FICTION_CODE:
+      return string(1, type) + " H " + author + ", " + title + ",";
+   case CHILDREN_CODE:
+      return string(1, type) + " H " + title + ", " + author + ",";
+   default:
+      return string(1, type) + " H " + to_string(1900 + i % 120) + " " +
+             to_string(1 + i % 12) + " Journal " + to_string(i / 12) + ",";
+   }
+}
+
+inline string makeBookKey(int i) { return makeBookKey(i, bookTypeOf(i)); }
+
+#endif
@@ -0,0 +1,491 @@
+/** @file benchSuite.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - One benchmark for each path a run goes through: building the catalog,
+ *     looking up a book, looking up a patron, parsing a command, executing
+ *     checkouts and returns, and the display library and display patron
+ *     reports
+ *   - Each case runs at several catalog sizes and prints one row per case
+ *     and size, as CSV or JSON, so runs can be compared by a script
+ *
+ * Implementation:
+ *   - Columns: case, books in the catalog, operations timed, nanoseconds and
+ *     heap allocations per operation, and the peak resident set in KB
+ *     (getrusage) of the process running that size, when the case finished
+ *   - Each size runs in a child process of its own, so the peak of a size
+ *     does not include what a larger size before it needed. The child
+ *     writes its rows to a pipe and the parent prints them
+ *   - Counts allocations with the operator new of benchCommon.h
+ *   - The catalog is benchCommon.h's, six in ten books fiction, three
+ *     children's and one periodical, in shuffled order. There is a patron
+ *     for every ten books, at most PATRON_TABLE_SIZE
+ *   - load times LibraryBuilder::createLibrary per book line. The other
+ *     cases share one BookDatabase, PatronDatabase and CommandFactory per
+ *     size. execute parses its checkouts and returns outside the timing and
+ *     times only execute(), and leaves every patron a history for the
+ *     display patron case. parse includes releasing the command
+ *   - Command and error output goes to a NullSink
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/benchSuite.cpp \
+ *       $(ls *.cpp | grep -v main.cpp) -o benchSuite
+ *   ./benchSuite [--json] [sizes...]
+ */
+
+#define COUNT_ALLOCATIONS
+#include "benchCommon.h"
+
+#include "bookDatabase.h"
+#include "commandFactory.h"
+#include "constants.h"
+#include "library.h"
+#include "libraryBuilder.h"
+#include "libraryCommand.h"
+#include "outputSink.h"
+#include "patronDatabase.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// one row of results
+struct Result {
+   string name;
+   int size;
+   long long operations;
+   double nsPerOp;
+   double allocationsPerOp;
+   long peakKB;
+};
+
+// the generated input for one catalog size
+struct Workload {
+   // book file and patron file lines
+   vector<string> bookLines;
+   vector<string> patronLines;
+
+   // each book as a command names it, and each patron ID, in the same
+   // order as the lines
+   vector<string> keys;
+   vector<string> patronIDs;
+};
+
+// -----------------------------------------------------------------------------
+/** makeWorkload()
+ * Generate the catalog and patrons
+ *
+ * @param books number of books
+ * @return the lines and keys, books in shuffled order
+ */
+Workload makeWorkload(int books)
+{
+   Workload work;
+   vector<int> order(books);
+   for (int i = 0; i < books; i++) {
+      order[i] = i;
+   }
+   mt19937 random(22);
+   for (int i = books - 1; i > 0; i--) {
+      swap(order[i], order[random() % (i + 1)]);
+   }
+
+   for (int i : order) {
+      work.bookLines.push_back(makeBookLine(i));
+      work.keys.push_back(makeBookKey(i));
+   }
+
+   int patrons = max(1, min(books / 10, PATRON_TABLE_SIZE));
+   for (int i = 0; i < patrons; i++) {
+      char id[16];
+      snprintf(id, sizeof(id), "%0*d", PATRON_ID_LENGTH, i);
+      work.patronIDs.push_back(id);
+      work.patronLines.push_back(string(id) + " Last" + to_string(i) +
+                                 " First");
+   }
+   return work;
+}
+
+// -----------------------------------------------------------------------------
+/** joinLines()
+ * The lines as one file
+ *
+ * @param lines the lines
+ * @return the lines, each ended by a newline
+ */
+string joinLines(const vector<string>& lines)
+{
+   string text;
+   for (const string& line : lines) {
+      text += line;
+      text += '\n';
+   }
+   return text;
+}
+
+// -----------------------------------------------------------------------------
+/** peakKB()
+ * Peak resident set of the process so far
+ *
+ * @return kilobytes
+ */
+long peakKB()
+{
+   rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss;
+}
+
+// -----------------------------------------------------------------------------
+/** Timer
+ *
+ * Time and allocations of the operations of one case. Can be paused for
+ * work that is not part of the case
+ */
+// -----------------------------------------------------------------------------
+class Timer
+{
+public:
+   void start()
+   {
+      allocationsAtStart = allocations;
+      startTime = chrono::steady_clock::now();
+   }
+
+   void stop()
+   {
+      chrono::duration<double, nano> elapsed =
+          chrono::steady_clock::now() - startTime;
+      nanoseconds += elapsed.count();
+      allocationsMade += allocations - allocationsAtStart;
+   }
+
+   Result result(const string& name, int size, long long operations) const
+   {
+      return Result{name,
+                    size,
+                    operations,
+                    nanoseconds / operations,
+                    (double)allocationsMade / operations,
+                    peakKB()};
+   }
+
+private:
+   chrono::steady_clock::time_point startTime;
+   long long allocationsAtStart = 0;
+   double nanoseconds = 0;
+   long long allocationsMade = 0;
+};
+
+// -----------------------------------------------------------------------------
+/** benchLoad()
+ * LibraryBuilder::createLibrary, per book line
+ *
+ * @param work the workload
+ * @return the row
+ */
+Result benchLoad(const Workload& work)
+{
+   string books = joinLines(work.bookLines);
+   string patrons = joinLines(work.patronLines);
+   int size = (int)work.bookLines.size();
+   int passes = max(1, 200000 / max(1, size));
+   Timer timer;
+   for (int pass = 0; pass < passes; pass++) {
+      istringstream bookStream(books);
+      istringstream patronStream(patrons);
+      LibraryBuilder builder;
+      timer.start();
+      Library* library = builder.createLibrary(bookStream, patronStream);
+      timer.stop();
+      delete library;
+   }
+   return timer.result("load", size, (long long)passes * size);
+}
+
+// -----------------------------------------------------------------------------
+/** runCommand()
+ * Parse and execute one command line
+ *
+ * @param factory factory that parses the line
+ * @param line the command line
+ * @return true if the line parsed and the command succeeded
+ */
+bool runCommand(CommandFactory& factory, const string& line)
+{
+   LibraryCommand* command = factory.createCommand(line);
+   return command != nullptr && command->execute();
+}
+
+// -----------------------------------------------------------------------------
+/** benchFixture()
+ * The cases that share one set of databases
+ *
+ * @param work the workload
+ * @param results receives a row for each case
+ */
+void benchFixture(const Workload& work, vector<Result>& results)
+{
+   int size = (int)work.bookLines.size();
+   int patrons = (int)work.patronIDs.size();
+   BookDatabase books;
+   PatronDatabase patronDB;
+   for (const string& line : work.bookLines) {
+      books.insertNewBook(line);
+   }
+   for (const string& line : work.patronLines) {
+      istringstream in(line);
+      patronDB.insertNewPatron(in);
+   }
+   CommandFactory factory(&books, &patronDB);
+   mt19937 random(23);
+
+   // book lookup
+   {
+      const long long lookups = 500000;
+      vector<const string*> keys(lookups);
+      for (long long i = 0; i < lookups; i++) {
+         keys[i] = &work.keys[random() % size];
+      }
+      Timer timer;
+      long long found = 0;
+      timer.start();
+      for (const string* key : keys) {
+         found += books.getBook(*key) != nullptr;
+      }
+      timer.stop();
+      if (found != lookups) {
+         cerr << "book lookup missed " << lookups - found << '\n';
+      }
+      results.push_back(timer.result("bookLookup", size, lookups));
+   }
+
+   // patron lookup
+   {
+      const long long lookups = 1000000;
+      vector<const string*> ids(lookups);
+      for (long long i = 0; i < lookups; i++) {
+         ids[i] = &work.patronIDs[random() % patrons];
+      }
+      Timer timer;
+      long long found = 0;
+      timer.start();
+      for (const string* id : ids) {
+         found += patronDB.getPatron(*id) != nullptr;
+      }
+      timer.stop();
+      if (found != lookups) {
+         cerr << "patron lookup missed " << lookups - found << '\n';
+      }
+      results.push_back(timer.result("patronLookup", size, lookups));
+   }
+
+   // checkout and return lines of a random patron and book, in pairs so
+   // every command succeeds
+   const int pairs = 200000;
+   vector<string> lines;
+   lines.reserve(pairs * 2);
+   for (int i = 0; i < pairs; i++) {
+      const string& id = work.patronIDs[random() % patrons];
+      const string& key = work.keys[random() % size];
+      lines.push_back("C " + id + " " + key);
+      lines.push_back("R " + id + " " + key);
+   }
+
+   // parse, no execute
+   {
+      Timer timer;
+      timer.start();
+      for (const string& line : lines) {
+         LibraryCommand* command = factory.createCommand(line);
+         if (command != nullptr) {
+            command->release();
+         }
+      }
+      timer.stop();
+      results.push_back(timer.result("parse", size, (long long)lines.size()));
+   }
+
+   // execute, parsing a batch at a time outside the timing
+   {
+      const int BATCH = 8192;
+      vector<LibraryCommand*> batch;
+      Timer timer;
+      long long failed = 0;
+      for (size_t start = 0; start < lines.size(); start += BATCH) {
+         size_t end = min(lines.size(), start + BATCH);
+         batch.clear();
+         for (size_t i = start; i < end; i++) {
+            batch.push_back(factory.createCommand(lines[i]));
+         }
+         timer.start();
+         for (LibraryCommand* command : batch) {
+            failed += !command->execute();
+         }
+         timer.stop();
+      }
+      if (failed != 0) {
+         cerr << "execute failed " << failed << '\n';
+      }
+      results.push_back(
+          timer.result("execute", size, (long long)lines.size()));
+   }
+
+   // display library, with one book checked out so the counts vary
+   {
+      runCommand(factory, "C " + work.patronIDs[0] + " " + work.keys[0]);
+      int displays = max(3, 2000000 / size);
+      Timer timer;
+      for (int i = 0; i < displays; i++) {
+         LibraryCommand* command = factory.createCommand("D");
+         timer.start();
+         command->execute();
+         timer.stop();
+      }
+      results.push_back(timer.result("displayLibrary", size, displays));
+   }
+
+   // display patron, each patron now has a history of about
+   // 2 * pairs / patrons commands
+   {
+      long long history = 2LL * pairs / patrons;
+      int displays = (int)max(10LL, 2000000 / (history + 1));
+      Timer timer;
+      for (int i = 0; i < displays; i++) {
+         LibraryCommand* command =
+             factory.createCommand("H " + work.patronIDs[i % patrons]);
+         timer.start();
+         command->execute();
+         timer.stop();
+      }
+      results.push_back(timer.result("displayPatron", size, displays));
+   }
+}
+
+// -----------------------------------------------------------------------------
+/** runSize()
+ * Run every case at one catalog size in a child process
+ *
+ * @param size books in the catalog
+ * @param results receives a row for each case
+ * @return true if the child ran and sent its rows
+ */
+bool runSize(int size, vector<Result>& results)
+{
+   int ends[2];
+   if (pipe(ends) != 0) {
+      return false;
+   }
+   pid_t child = fork();
+   if (child < 0) {
+      close(ends[0]);
+      close(ends[1]);
+      return false;
+   }
+   if (child == 0) {
+      close(ends[0]);
+      Workload work = makeWorkload(size);
+      vector<Result> rows;
+      rows.push_back(benchLoad(work));
+      benchFixture(work, rows);
+      FILE* out = fdopen(ends[1], "w");
+      for (const Result& r : rows) {
+         fprintf(out, "%s %d %lld %.17g %.17g %ld\n", r.name.c_str(), r.size,
+                 r.operations, r.nsPerOp, r.allocationsPerOp, r.peakKB);
+      }
+      fclose(out);
+      _exit(0);
+   }
+
+   close(ends[1]);
+   FILE* in = fdopen(ends[0], "r");
+   char name[64];
+   Result r;
+   while (fscanf(in, "%63s %d %lld %lf %lf %ld", name, &r.size,
+                 &r.operations, &r.nsPerOp, &r.allocationsPerOp,
+                 &r.peakKB) == 6) {
+      r.name = name;
+      results.push_back(r);
+   }
+   fclose(in);
+   int status = 0;
+   waitpid(child, &status, 0);
+   return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// -----------------------------------------------------------------------------
+/** printResults()
+ * Print the rows
+ *
+ * @param results the rows
+ * @param json true for a JSON array, false for CSV with a header
+ */
+void printResults(const vector<Result>& results, bool json)
+{
+   if (!json) {
+      printf("case,size,ops,ns_per_op,allocs_per_op,peak_rss_kb\n");
+      for (const Result& r : results) {
+         printf("%s,%d,%lld,%.1f,%.3f,%ld\n", r.name.c_str(), r.size,
+                r.operations, r.nsPerOp, r.allocationsPerOp, r.peakKB);
+      }
+      return;
+   }
+   printf("[\n");
+   for (size_t i = 0; i < results.size(); i++) {
+      const Result& r = results[i];
+      printf("  {\"case\": \"%s\", \"size\": %d, \"ops\": %lld, "
+             "\"ns_per_op\": %.1f, \"allocs_per_op\": %.3f, "
+             "\"peak_rss_kb\": %ld}%s\n",
+             r.name.c_str(), r.size, r.operations, r.nsPerOp,
+             r.allocationsPerOp, r.peakKB,
+             i + 1 < results.size() ? "," : "");
+   }
+   printf("]\n");
+}
+
+int main(int argc, char* argv[])
+{
+   bool json = false;
+   vector<int> sizes;
+   for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "--json") == 0) {
+         json = true;
+      } else if (atoi(argv[i]) > 0) {
+         sizes.push_back(atoi(argv[i]));
+      } else {
+         cerr << "usage: " << argv[0] << " [--json] [sizes...]\n";
+         return 1;
+      }
+   }
+   if (sizes.empty()) {
+      sizes = {1000, 10000, 100000};
+   }
+   sort(sizes.begin(), sizes.end());
+
+   NullSink nullSink;
+   ostream nowhere(&nullSink);
+   OutputScope quiet(nowhere);
+
+   vector<Result> results;
+   for (int size : sizes) {
+      if (!runSize(size, results)) {
+         cerr << "size " << size << " failed\n";
+         return 1;
+      }
+   }
+   printResults(results, json);
+   return 0;
+}
@@ -0,0 +1,183 @@
+/** @file bookParseBench.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Throughput of parsing book lines, in MB of input per second, for the
+ *     old stringstream path and the FieldReader paths that replaced it
+ *   - stream: a stringstream per line, then getline and operator>> on a
+ *     second stringstream, the way the builder and setData used to parse
+ *   - createBook: BookFactory::createBook(string_view), which builds and
+ *     frees a Book per line
+ *   - createKey: BookFactory::createKey, the parser alone, no allocation
+ *
+ * Implementation:
+ *   - The lines are benchCommon.h's catalog: a repeating mix of fiction,
+ *     children and periodical records, with periodicals in both the catalog
+ *     and the command form
+ *   - Every path parses every line the same number of times. Error output
+ *     goes to a NullSink so it is not part of the measurement
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/bookParseBench.cpp \
+ *       $(ls *.cpp | grep -v main.cpp) -o bookParseBench
+ *   ./bookParseBench [lines] [passes]
+ */
+
+#include "benchCommon.h"
+
+#include "book.h"
+#include "bookKey.h"
+#include "bookfactory.h"
+#include "outputSink.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+/** makeLine()
+ * Make book line number i
+ *
+ * Every fourth line is a periodical in the command form, the others are
+ * benchCommon.h's book file lines of each type in turn
+ * @param i number of the line
+ * @return a fiction, children or periodical line
+ */
+string makeLine(int i)
+{
+   static const char TYPES[] = {FICTION_CODE, CHILDREN_CODE, PERIODICAL_CODE};
+   if (i % 4 == 3) {
+      return makeBookKey(i, PERIODICAL_CODE);
+   }
+   return makeBookLine(i, TYPES[i % 4]);
+}
+
+// -----------------------------------------------------------------------------
+/** streamParse()
+ * Parse a line the old way
+ *
+ * Same steps the builder and setData took before FieldReader: a
+ * stringstream for the line, getline the rest into a string, a second
+ * stringstream for the fields, and a regex for the periodical form
+ * @param line one book line
+ * @param key set to the fields, pointing into author and title
+ * @param author holds the author
+ * @param title holds the title
+ */
+void streamParse(const string& line, BookKey& key, string& author,
+                 string& title)
+{
+   static const regex commandReg("\\d{1,4}\\s\\d\\d?\\s.*");
+   stringstream inputLine;
+   inputLine.str(line);
+   char type = inputLine.get();
+   string rest;
+   inputLine.get();
+   inputLine.get(); // format
+   if (inputLine.peek() == ' ') {
+      inputLine.get();
+   } else {
+      inputLine.unget();
+   }
+   getline(inputLine, rest);
+   stringstream data;
+   data.str(rest);
+
+   key.year = key.month = 0;
+   if (type == 'P' && regex_match(rest, commandReg)) {
+      data >> key.year;
+      data >> key.month;
+      data.get();
+      getline(data, title, ',');
+   } else if (type == 'P') {
+      getline(data, title, ',');
+      data >> key.month;
+      data >> key.year;
+   } else {
+      getline(data, author, ',');
+      data.get();
+      getline(data, title, ',');
+      data >> key.year;
+   }
+   key.typeCode = type;
+   key.author = author;
+   key.title = title;
+}
+
+// -----------------------------------------------------------------------------
+/** mbPerSecond()
+ * Throughput
+ *
+ * @param start time the parsing started
+ * @param bytes bytes of input parsed since start
+ * @return MB parsed per second
+ */
+double mbPerSecond(chrono::steady_clock::time_point start, double bytes)
+{
+   chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+   return bytes / (1 << 20) / elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+   int count = argc > 1 ? atoi(argv[1]) : 100000;
+   int passes = argc > 2 ? atoi(argv[2]) : 10;
+   BookFactory factory;
+
+   vector<string> lines;
+   double bytes = 0;
+   for (int i = 0; i < count; i++) {
+      lines.push_back(makeLine(i));
+      bytes += lines.back().size() + 1;
+   }
+   bytes *= passes;
+
+   NullSink nullSink;
+   ostream nowhere(&nullSink);
+   OutputScope quiet(nowhere);
+
+   long long checksum = 0;
+   string author;
+   string title;
+   BookKey key;
+   auto start = chrono::steady_clock::now();
+   for (int pass = 0; pass < passes; pass++) {
+      for (const string& line : lines) {
+         streamParse(line, key, author, title);
+         checksum += key.year + key.title.size();
+      }
+   }
+   double streamMb = mbPerSecond(start, bytes);
+
+   start = chrono::steady_clock::now();
+   for (int pass = 0; pass < passes; pass++) {
+      for (const string& line : lines) {
+         Book* book = factory.createBook(string_view(line));
+         checksum += book != nullptr;
+         delete book;
+      }
+   }
+   double bookMb = mbPerSecond(start, bytes);
+
+   start = chrono::steady_clock::now();
+   for (int pass = 0; pass < passes; pass++) {
+      for (const string& line : lines) {
+         if (factory.createKey(line, key)) {
+            checksum += key.year + key.title.size();
+         }
+      }
+   }
+   double keyMb = mbPerSecond(start, bytes);
+
+   cout << count << " lines x " << passes << " passes, checksum " << checksum
+        << endl;
+   cout << "stream:      " << streamMb << " MB/s" << endl;
+   cout << "createBook:  " << bookMb << " MB/s" << endl;
+   cout << "createKey:   " << keyMb << " MB/s" << endl;
+   return 0;
+}
@@ -0,0 +1,163 @@
+/** @file checkoutBench.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Throughput of checkouts and returns on patrons' current checkouts,
+ *     the CheckoutSet Patron uses against the unordered_map it used before
+ *   - Prints nanoseconds per operation and the books held at the end
+ *
+ * Implementation:
+ *   - Patron mix: most hold one to three books, some up to eight and one in
+ *     a hundred is a heavy borrower holding up to 200
+ *   - The operations are generated up front and applied to both containers
+ *     in the same order. About one return in twenty is for a book the
+ *     patron does not hold, like the failed returns in the command files.
+ *     The map does what Patron did, operator[] on every return, so it
+ *     keeps an entry for every book a patron ever touched
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/checkoutBench.cpp \
+ *       $(ls *.cpp | grep -v main.cpp) -o checkoutBench
+ *   ./checkoutBench [patrons] [operations]
+ */
+
+#include "bookfactory.h"
+#include "checkoutSet.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// one checkout or return
+struct Operation {
+   int patron;
+   const Book* book;
+   bool checkout;
+};
+
+// -----------------------------------------------------------------------------
+/** makeOperations()
+ * Generate the operations
+ *
+ * Each patron gets a limit from the mix and checks out until it is
+ * reached, after which a checkout and a return are equally likely
+ * @param books the books to check out
+ * @param patrons number of patrons
+ * @param count number of operations
+ * @return the operations in the order to apply them
+ */
+vector<Operation> makeOperations(const vector<Book*>& books, int patrons,
+                                 int count)
+{
+   mt19937 random(18);
+   vector<int> limit(patrons);
+   for (int i = 0; i < patrons; i++) {
+      int kind = random() % 100;
+      limit[i] = kind == 0   ? 1 + random() % 200
+                 : kind < 10 ? 1 + random() % 8
+                             : 1 + random() % 3;
+   }
+
+   vector<vector<const Book*>> held(patrons);
+   vector<Operation> operations;
+   operations.reserve(count);
+   while ((int)operations.size() < count) {
+      int patron = random() % patrons;
+      vector<const Book*>& holding = held[patron];
+      bool checkout = holding.empty() ||
+                      ((int)holding.size() < limit[patron] && random() % 2);
+      if (checkout) {
+         const Book* book = books[random() % books.size()];
+         holding.push_back(book);
+         operations.push_back(Operation{patron, book, true});
+      } else if (random() % 20 == 0) {
+         const Book* book = books[random() % books.size()];
+         operations.push_back(Operation{patron, book, false});
+      } else {
+         int index = random() % holding.size();
+         const Book* book = holding[index];
+         holding[index] = holding.back();
+         holding.pop_back();
+         operations.push_back(Operation{patron, book, false});
+      }
+   }
+   return operations;
+}
+
+// -----------------------------------------------------------------------------
+/** nsPer()
+ * Nanoseconds per operation
+ *
+ * @param start time the operations started
+ * @param operations number of operations done since start
+ * @return average nanoseconds per operation
+ */
+double nsPer(chrono::steady_clock::time_point start, long long operations)
+{
+   chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+   return elapsed.count() / operations;
+}
+
+int main(int argc, char* argv[])
+{
+   int patronCount = argc > 1 ? atoi(argv[1]) : 10000;
+   int operationCount = argc > 2 ? atoi(argv[2]) : 5000000;
+
+   BookFactory factory;
+   vector<Book*> books;
+   for (int i = 0; i < 20000; i++) {
+      stringstream line;
+      line << "F Author " << i % 97 << ", Title number " << i << ", "
+           << 1900 + i % 120;
+      books.push_back(factory.createBook(line));
+   }
+   vector<Operation> operations =
+       makeOperations(books, patronCount, operationCount);
+
+   // what Patron::addBook and removeBook did with the map
+   vector<unordered_map<const Book*, int>> maps(patronCount);
+   auto mapStart = chrono::steady_clock::now();
+   for (const Operation& op : operations) {
+      unordered_map<const Book*, int>& checkouts = maps[op.patron];
+      if (op.checkout) {
+         checkouts[op.book]++;
+      } else if (checkouts[op.book] > 0) {
+         checkouts[op.book]--;
+      }
+   }
+   double mapNs = nsPer(mapStart, operationCount);
+
+   vector<CheckoutSet> sets(patronCount);
+   auto setStart = chrono::steady_clock::now();
+   for (const Operation& op : operations) {
+      if (op.checkout) {
+         sets[op.patron].add(op.book);
+      } else {
+         sets[op.patron].remove(op.book);
+      }
+   }
+   double setNs = nsPer(setStart, operationCount);
+
+   long long mapEntries = 0;
+   long long setEntries = 0;
+   for (int i = 0; i < patronCount; i++) {
+      mapEntries += maps[i].size();
+      setEntries += sets[i].size();
+   }
+
+   cout << patronCount << " patrons, " << operationCount << " operations\n";
+   cout << "unordered_map  " << mapNs << " ns/op, " << mapEntries
+        << " entries held\n";
+   cout << "CheckoutSet    " << setNs << " ns/op, " << setEntries
+        << " entries held\n";
+
+   for (Book* book : books) {
+      delete book;
+   }
+   return 0;
+}
@@ -0,0 +1,131 @@
+/** @file snapshotBench.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Startup time of a library built from the text files against the same
+ *     library loaded from a snapshot, and a check that both hold the same
+ *     books, counts, patrons, checkouts and histories
+ *
+ * Implementation:
+ *   - Builds the library from the book and patron files, runs the commands
+ *     so patrons have checkouts and history, then saves a snapshot
+ *   - Times the text build and the snapshot load over several passes, then
+ *     compares the last loaded library with the text built one. The command
+ *     run is not part of either time. Command and error output goes to a
+ *     NullSink
+ *   - Exits with 1 if the libraries are not equivalent
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/snapshotBench.cpp \
+ *       $(ls *.cpp | grep -v main.cpp) -o snapshotBench
+ *   ./snapshotBench [books] [patrons] [commands] [snapshot] [passes]
+ */
+
+#include "library.h"
+#include "libraryBuilder.h"
+#include "librarySnapshot.h"
+#include "lineSource.h"
+#include "outputSink.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+/** buildFromText()
+ * Build a library from the text files
+ *
+ * @param books name of the book file
+ * @param patrons name of the patron file
+ * @return the new library
+ */
+Library* buildFromText(const string& books, const string& patrons)
+{
+   LineSource bookLines(books);
+   LineSource patronLines(patrons);
+   LibraryBuilder builder;
+   return builder.createLibrary(bookLines, patronLines);
+}
+
+// -----------------------------------------------------------------------------
+/** millisecondsSince()
+ * Elapsed time
+ *
+ * @param start time the work started
+ * @return milliseconds since start
+ */
+double millisecondsSince(chrono::steady_clock::time_point start)
+{
+   chrono::duration<double, milli> elapsed =
+       chrono::steady_clock::now() - start;
+   return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+   string books = argc > 1 ? argv[1] : "data4books.txt";
+   string patrons = argc > 2 ? argv[2] : "data4patrons.txt";
+   string commands = argc > 3 ? argv[3] : "data4commands.txt";
+   string path = argc > 4 ? argv[4] : "library.snap";
+   int passes = argc > 5 ? atoi(argv[5]) : 5;
+
+   NullSink nullSink;
+   ostream nowhere(&nullSink);
+   OutputScope quiet(nowhere);
+
+   double textMs = 0;
+   Library* text = nullptr;
+   for (int pass = 0; pass < passes; pass++) {
+      delete text;
+      auto start = chrono::steady_clock::now();
+      text = buildFromText(books, patrons);
+      textMs += millisecondsSince(start);
+   }
+
+   LineSource commandLines(commands);
+   text->processCommands(commandLines);
+
+   auto start = chrono::steady_clock::now();
+   if (!LibrarySnapshot::save(*text, path)) {
+      cerr << "could not write " << path << endl;
+      return 1;
+   }
+   double saveMs = millisecondsSince(start);
+
+   double loadMs = 0;
+   Library* loaded = nullptr;
+   for (int pass = 0; pass < passes; pass++) {
+      delete loaded;
+      start = chrono::steady_clock::now();
+      loaded = LibrarySnapshot::load(path);
+      loadMs += millisecondsSince(start);
+      if (loaded == nullptr) {
+         cerr << "could not load " << path << endl;
+         return 1;
+      }
+   }
+
+   bool same = LibrarySnapshot::equivalent(*text, *loaded);
+   struct stat info;
+   long long textBytes = 0;
+   if (stat(books.c_str(), &info) == 0) {
+      textBytes += info.st_size;
+   }
+   if (stat(patrons.c_str(), &info) == 0) {
+      textBytes += info.st_size;
+   }
+   long long snapBytes = stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+
+   cout << "text:      " << textMs / passes << " ms, " << textBytes
+        << " bytes" << endl;
+   cout << "snapshot:  " << loadMs / passes << " ms, " << snapBytes
+        << " bytes, saved in " << saveMs << " ms" << endl;
+   cout << "equivalent: " << (same ? "yes" : "NO") << endl;
+
+   delete text;
+   delete loaded;
+   return same ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/** @file treeLookupBench.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Microbenchmark of one book lookup in a BSTree, ordered through the
+ *     virtual BSTData operators, against the same lookup in a BookShelf,
+ *     the SortedTree<Book, BookCompare> BookDatabase uses
+ *   - Prints nanoseconds and comparisons per lookup, and the lookups that
+ *     found their book, for each
+ *
+ * Implementation:
+ *   - Both trees are balanced and arena-backed and hold the same fiction
+ *     books, so the only difference is the comparator
+ *   - Lookups use separate key books in a shuffled order, like commands do
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/treeLookupBench.cpp \
+ *       $(ls *.cpp | grep -v main.cpp) -o treeLookupBench
+ *   ./treeLookupBench [books] [lookups]
+ */
+
+#include "benchCommon.h"
+
+#include "BSTree.h"
+#include "bookCompare.h"
+#include "bookDatabase.h"
+#include "bookfactory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+/** makeBook()
+ * Make fiction book number i
+ *
+ * The fiction book of benchCommon.h's catalog
+ * @param factory factory that builds the book
+ * @param i number of the book
+ * @return new fiction book
+ */
+Book* makeBook(const BookFactory& factory, int i)
+{
+   return factory.createBook(makeBookLine(i, FICTION_CODE));
+}
+
+// -----------------------------------------------------------------------------
+/** nsPer()
+ * Nanoseconds per operation
+ *
+ * @param start time the operations started
+ * @param operations number of operations done since start
+ * @return average nanoseconds per operation
+ */
+double nsPer(chrono::steady_clock::time_point start, long long operations)
+{
+   chrono::duration<double, nano> elapsed =
+      chrono::steady_clock::now() - start;
+   return elapsed.count() / operations;
+}
+
+int main(int argc, char* argv[])
+{
+   int books = argc > 1 ? atoi(argv[1]) : 100000;
+   long long lookups = argc > 2 ? atoll(argv[2]) : 2000000;
+   BookFactory factory;
+
+   BSTree virtualTree(TREE_BALANCED | TREE_ARENA);
+   BookShelf typedTree(TREE_BALANCED | TREE_ARENA);
+   vector<Book*> keys;
+   for (int i = 0; i < books; i++) {
+      virtualTree.insert(makeBook(factory, i));
+      typedTree.insert(makeBook(factory, i));
+      keys.push_back(makeBook(factory, i));
+   }
+   shuffle(keys.begin(), keys.end(), mt19937(12345));
+
+   long long virtualFound = 0;
+   auto start = chrono::steady_clock::now();
+   for (long long i = 0; i < lookups; i++) {
+      BSTData* result = nullptr;
+      virtualFound += virtualTree.retrieve(*keys[i % books], result);
+   }
+   double virtualNs = nsPer(start, lookups);
+
+   long long typedFound = 0;
+   start = chrono::steady_clock::now();
+   for (long long i = 0; i < lookups; i++) {
+      typedFound += typedTree.find(*keys[i % books]) != nullptr;
+   }
+   double typedNs = nsPer(start, lookups);
+
+   cout << books << " books, " << lookups << " lookups in each tree" << endl;
+   cout << "BSTree (virtual):   " << virtualNs << " ns/lookup, "
+        << (double)virtualTree.getTotalComparisons() / lookups
+        << " comparisons/lookup, " << virtualFound << " found" << endl;
+   cout << "BookShelf (typed):  " << typedNs << " ns/lookup, "
+        << (double)typedTree.getTotalComparisons() / lookups
+        << " comparisons/lookup, " << typedFound << " found" << endl;
+
+   for (Book* key : keys) {
+      delete key;
+   }
+   return 0;
+}
@@ -15,9 +15,15 @@
  *   - One book object can represent multiple copies of the same book using the
  *     count member variable
  *   - count can be decreased or increased
+ *   - A book remembers whether its count changed since BookDatabase last
+ *     rendered its report row, so unchanged rows are reused
  */
 
 #include "book.h"
+#include "bookKey.h"
+#include "fieldReader.h"
+#include "stringPool.h"
+#include <istream>
 
 using namespace std;
 
@@ -40,7 +46,8 @@ Book::Book()
    count = -1;
    maxCount = -1;
    format = 'H';
-   type = '0';
+   type = "0";
+   changed = true;
 }
 
 // -------------------------------------------------------------------------
@@ -67,6 +74,7 @@ bool Book::addBook()
 {
    if (count < maxCount) {
       count++;
+      changed = true;
       return true;
    }
    return false;
@@ -86,6 +94,7 @@ bool Book::removeBook()
 {
    if (count > 0) {
       count--;
+      changed = true;
       return true;
    }
    return false;
@@ -106,12 +115,13 @@ bool Book::checkAvailability() const { return count > 0; }
 /** getType()
  * get book type
  *
- * Return the type of book
+ * Return the type of book, TYPE_FICTION, TYPE_CHILDREN or
+ * TYPE_PERIODICAL. Nothing is copied.
  * @pre None
  * @post None. const
- * @return the book type as a string
+ * @return view of the book type name, valid for the whole program
  */
-string Book::getType() const { return type; }
+string_view Book::getType() const { return type; }
 
 // -------------------------------------------------------------------------
 /** getTitle()
@@ -120,6 +130,85 @@ string Book::getType() const { return type; }
  * Return the title of current book
  * @pre None
  * @post None. const
- * @return string representing book title
+ * @return view of the book title, valid while the book's factory lives
  */
-string Book::getTitle() const { return title; }
+string_view Book::getTitle() const { return title; }
+
+// -------------------------------------------------------------------------
+/** setData()
+ * input data into node
+ *
+ * Reads the rest of the line and parses it with parseKey, so catalog
+ * loading and command parsing share one parser. There is no factory
+ * pool here, so the book keeps its own copy of the author and title,
+ * freed with the book.
+ * @param is stream positioned after the type code
+ * @pre None.
+ * @post line of input is read. Book contains line data if it was valid
+ * @return true if line of data was read, false if no line or bad format
+ */
+bool Book::setData(istream& is)
+{
+   // reused so reading a line does not allocate once it has grown
+   thread_local string line;
+   getline(is, line);
+   FieldReader in(line);
+
+   BookKey key;
+   if (!parseKey(in, key)) {
+      return false;
+   }
+   setNames(key.author, key.title);
+   year = key.year;
+   month = key.month;
+   return true;
+}
+
+// -------------------------------------------------------------------------
+/** setData()
+ * input data into node
+ *
+ * Parses the rest of the line with parseKey and copies the fields into
+ * this book. The author and title are interned in strings, nothing is
+ * allocated for a name the pool already holds.
+ * @param in reader positioned after the type code
+ * @param strings pool the author and title are kept in
+ * @pre strings outlives this book
+ * @post line of input is read. Book contains line data if it was valid
+ * @return true if line of data was read, false if no line or bad format
+ */
+bool Book::setData(FieldReader& in, StringPool& strings)
+{
+   BookKey key;
+   if (!parseKey(in, key)) {
+      return false;
+   }
+   author = strings.intern(key.author);
+   title = strings.intern(key.title);
+   year = key.year;
+   month = key.month;
+   return true;
+}
+
+// -------------------------------------------------------------------------
+/** setNames()
+ * Keep a copy of the names
+ *
+ * Copies author and title into storage the book owns, freed with the
+ * book, and points the book's views at the copy. For books that have no
+ * factory pool, or get their names from another book.
+ * @param newAuthor the author, may be a view into this book
+ * @param newTitle the title, may be a view into this book
+ * @pre None.
+ * @post author and title hold the text, owned by this book
+ */
+void Book::setNames(string_view newAuthor, string_view newTitle)
+{
+   // built before the old copy is freed, the names may point into it
+   unique_ptr<string> names(new string(newAuthor));
+   names->append(newTitle);
+   ownedNames = move(names);
+   string_view copy = *ownedNames;
+   author = copy.substr(0, newAuthor.size());
+   title = copy.substr(newAuthor.size());
+}
@@ -15,16 +15,23 @@
  *   - One book object can represent multiple copies of the same book using the
  *     count member variable
  *   - count can be decreased or increased
+ *   - A book remembers whether its count changed since BookDatabase last
+ *     rendered its report row, so unchanged rows are reused
  */
 
 #ifndef BOOK_H
 #define BOOK_H
 
 #include "BSTData.h"
+#include <memory>
 #include <string>
+#include <string_view>
 
 class BSTData;
 class Patron;
+class FieldReader;
+class StringPool;
+struct BookKey;
 
 using namespace std;
 
@@ -32,6 +39,9 @@ using namespace std;
 // instantiation
 class Book : public BSTData
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
 public:
    // -------------------------------------------------------------------------
    /** Book()
@@ -106,12 +116,33 @@ public:
    /** getType()
     * get book type
     *
-    * Return the type of book
+    * Return the type of book, TYPE_FICTION, TYPE_CHILDREN or
+    * TYPE_PERIODICAL. Nothing is copied.
+    * @pre None
+    * @post None. const
+    * @return view of the book type name, valid for the whole program
+    */
+   string_view getType() const;
+
+   // -------------------------------------------------------------------------
+   /** getTypeCode()
+    * get book type code
+    *
+    * Return the one character code of the book type, FICTION_CODE,
+    * CHILDREN_CODE or PERIODICAL_CODE. Defined here so it can be inlined.
     * @pre None
     * @post None. const
     * @return char representing book type
     */
-   string getType() const;
+   char getTypeCode() const { return typeCode; }
+
+   // -------------------------------------------------------------------------
+   /** isChanged() / clearChanged()
+    * Whether the count changed since the book's report row was rendered,
+    * and mark the row as rendered. A new book counts as changed.
+    */
+   bool isChanged() const { return changed; }
+   void clearChanged() { changed = false; }
 
    // -------------------------------------------------------------------------
    /** display Countless
@@ -137,6 +168,51 @@ public:
     */
    virtual ostream& displayHeader(ostream&) const = 0;
 
+   // -------------------------------------------------------------------------
+   /** parseKey()
+    * Parse a book key
+    *
+    * Reads the same input setData reads, with the same checks and error
+    * messages, into a BookKey instead of this book. Called on the factory's
+    * prototype, the key's fields point into the input.
+    * @param in the rest of the line after the type code
+    * @param key set to the book's identifying fields
+    * @pre None
+    * @post the line is read. key holds its data if it was valid
+    * @return true if the line was valid, false if bad format
+    */
+   virtual bool parseKey(FieldReader& in, BookKey& key) const = 0;
+
+   // -------------------------------------------------------------------------
+   /** setData()
+    * input data into node
+    *
+    * Reads the rest of the line and parses it with parseKey, so catalog
+    * loading and command parsing share one parser. There is no factory
+    * pool here, so the book keeps its own copy of the author and title,
+    * freed with the book.
+    * @param is stream positioned after the type code
+    * @pre None.
+    * @post line of input is read. Book contains line data if it was valid
+    * @return true if line of data was read, false if no line or bad format
+    */
+   virtual bool setData(istream& is);
+
+   // -------------------------------------------------------------------------
+   /** setData()
+    * input data into node
+    *
+    * Parses the rest of the line with parseKey and copies the fields into
+    * this book. The author and title are interned in strings, nothing is
+    * allocated for a name the pool already holds.
+    * @param in reader positioned after the type code
+    * @param strings pool the author and title are kept in
+    * @pre strings outlives this book
+    * @post line of input is read. Book contains line data if it was valid
+    * @return true if line of data was read, false if no line or bad format
+    */
+   bool setData(FieldReader& in, StringPool& strings);
+
    // -------------------------------------------------------------------------
    /** getTitle()
     * get book title
@@ -144,16 +220,52 @@ public:
     * Return the title of current book
     * @pre None
     * @post None. const
-    * @return string representing book title
+    * @return view of the book title, valid while the book's factory lives
     */
-   string getTitle() const;
+   string_view getTitle() const;
 
 protected:
-   // author of book
-   string author;
+   // -------------------------------------------------------------------------
+   /** setNames()
+    * Keep a copy of the names
+    *
+    * Copies author and title into storage the book owns, freed with the
+    * book, and points the book's views at the copy. For books that have no
+    * factory pool, or get their names from another book.
+    * @param newAuthor the author, may be a view into this book
+    * @param newTitle the title, may be a view into this book
+    * @pre None.
+    * @post author and title hold the text, owned by this book
+    */
+   void setNames(string_view newAuthor, string_view newTitle);
 
-   // title of book
-   string title;
+   // -------------------------------------------------------------------------
+   /** sameView()
+    * Same text in the same storage
+    *
+    * True when both views start at the same character and are the same
+    * length, so their text is equal without comparing it. Views that differ
+    * here can still hold equal text.
+    * @param left one view
+    * @param right the other view
+    * @pre None.
+    * @post None.
+    * @return true if left and right view the same characters
+    */
+   static bool sameView(string_view left, string_view right)
+   {
+      return left.data() == right.data() && left.size() == right.size();
+   }
+
+   // author and title of book, views of the text in the StringPool of the
+   // factory that built it. Equal names share one copy, so a view with the
+   // same data pointer is the same name
+   string_view author;
+   string_view title;
+
+   // author then title, for a book whose names were set by setNames, null
+   // otherwise
+   unique_ptr<string> ownedNames;
 
    // year book was published
    int year;
@@ -170,11 +282,15 @@ protected:
    // format of book
    char format;
 
-   // book type;
-   string type;
+   // book type name, one of the TYPE_ string constants
+   string_view type;
 
    // book type code
    char typeCode;
+
+   // true until the book's report row is rendered, and again after
+   // addBook or removeBook changes count
+   bool changed;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/** @file bookCompare.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Three-way comparison of two books of the same type, or of a BookKey
+ *     and a book, for the SortedTree shelves of BookDatabase
+ *
+ * Implementation:
+ *   - Switches on the type code and calls the inline compare() of the
+ *     concrete type, so a shelf lookup makes no virtual calls
+ *   - Any other Book type falls back to the virtual operator< and ==
+ */
+
+#ifndef BOOKCOMPARE_H
+#define BOOKCOMPARE_H
+
+#include "book.h"
+#include "bookKey.h"
+#include "children.h"
+#include "constants.h"
+#include "fiction.h"
+#include "periodical.h"
+
+using namespace std;
+
+struct BookCompare {
+   // -------------------------------------------------------------------------
+   /** operator()
+    * Compare books
+    *
+    * Compares two books of the same type by that type's ordering
+    * @param lhs left book
+    * @param rhs right book, same type as lhs
+    * @pre lhs and rhs are the same type of book
+    * @post None.
+    * @return negative int if lhs < rhs, 0 if equal, positive if lhs > rhs
+    */
+   int operator()(const Book& lhs, const Book& rhs) const
+   {
+      switch (lhs.getTypeCode()) {
+      case FICTION_CODE:
+         return static_cast<const Fiction&>(lhs).compare(
+            static_cast<const Fiction&>(rhs));
+      case CHILDREN_CODE:
+         return static_cast<const Children&>(lhs).compare(
+            static_cast<const Children&>(rhs));
+      case PERIODICAL_CODE:
+         return static_cast<const Periodical&>(lhs).compare(
+            static_cast<const Periodical&>(rhs));
+      default:
+         if (lhs < rhs) {
+            return -1;
+         }
+         return lhs == rhs ? 0 : 1;
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   /** operator()
+    * Compare key and book
+    *
+    * Compares a key with a book of the key's type by that type's ordering,
+    * so a shelf can be searched by key
+    * @param key key on the left
+    * @param book book on the right, same type as key
+    * @pre the key's type is one of the three book types
+    * @post None.
+    * @return negative int if key < book, 0 if equal, positive if key > book
+    */
+   int operator()(const BookKey& key, const Book& book) const
+   {
+      switch (key.typeCode) {
+      case FICTION_CODE:
+         return static_cast<const Fiction&>(book).compareKey(key);
+      case CHILDREN_CODE:
+         return static_cast<const Children&>(book).compareKey(key);
+      default:
+         return static_cast<const Periodical&>(book).compareKey(key);
+      }
+   }
+};
+
+#endif
@@ -9,16 +9,30 @@
  *
  * Implementation:
  *   -  Contains an array of pointers to BSTrees, each element reprisents a
- *      hashed value corresponding to booktype
+ *      hashed value corresponding to booktype. Each shelf is a SortedTree
+ *      of Book ordered by BookCompare, so lookups make no virtual calls
  *   -  Uses a "Book Factory" to produce books to insert
+ *   -  Lookups parse the command's book into a BookKey and search the shelf
+ *      with it, no Book is built to search with
+ *   -  Books can also be staged and then committed in one go. Committing
+ *      sorts each shelf's staged books once and rebuilds the shelf as a
+ *      perfectly balanced tree, which is much faster than one insert per
+ *      book for a large catalog
+ *   -  displayAll keeps each shelf's rendered rows between displays. Only
+ *      the rows of books whose count changed are rendered again, and every
+ *      row of a shelf that gained books, so a display of a large catalog is
+ *      mostly one write per shelf
  *
  */
 
 #include "bookDatabase.h"
-#include "BSTree.h"
+#include "bookCompare.h"
 #include "book.h"
 #include "constants.h"
+#include "outputSink.h"
+#include <algorithm>
 #include <iomanip>
+#include <sstream>
 #include <vector>
 
 using namespace std;
@@ -32,12 +46,25 @@ using namespace std;
  * @pre None.
  * @post BookDatabase object exists
  */
-BookDatabase::BookDatabase()
+BookDatabase::BookDatabase() : BookDatabase(TREE_BALANCED | TREE_ARENA) {}
+
+// ------------------------------------------------------------------------
+/** BookDatabase(treeOptions)
+ * Constructor with tree options
+ *
+ * Constructs a BookDatabase whose shelves are trees built with the given
+ * options. The default constructor uses TREE_BALANCED | TREE_ARENA.
+ * @param treeOptions TreeOption values combined with |
+ * @pre None.
+ * @post BookDatabase object exists
+ */
+BookDatabase::BookDatabase(int treeOptions)
 {
    for (int i = 0; i < HASH_SIZE; i++) {
-      bookShelf[i] =
-          new BSTree(); // make it fixed siz e using final const HASH_SIZE?
+      bookShelf[i] = new BookShelf(treeOptions);
    }
+   stagedCount = 0;
+   reportCache = true;
 }
 
 // ------------------------------------------------------------------------
@@ -52,6 +79,9 @@ BookDatabase::~BookDatabase()
 {
    for (int i = 0; i < HASH_SIZE; i++) {
       delete bookShelf[i];
+      for (StagedBook& entry : staged[i]) {
+         delete entry.book;
+      }
    }
 }
 
@@ -60,29 +90,181 @@ BookDatabase::~BookDatabase()
  * Insert Method
  *
  * Inserts the given book into the correct BST
- * @param is book input
+ * @param line one line of book input, parsed in place
  * @pre None
  * @post newBook is added to the right BST, if successful
  * @return true if newBook was successfully inserted
  */
-bool BookDatabase::insertNewBook(istream& is)
+bool BookDatabase::insertNewBook(string_view line)
 {
-   Book* newBook = bookFactory.createBook(is);
+   Book* newBook = parseBook(line);
    if (newBook == nullptr) {
       return false;
    }
+   return addBook(newBook);
+}
+
+//-------------------------------------------------------------------------
+/** parseBook()
+ * Parse Method
+ *
+ * Builds a book from one line without adding it to the database. Input
+ * errors are printed to output(). Only reads the database, so several
+ * threads can parse at once.
+ * @param line one line of book input, parsed in place
+ * @pre None
+ * @post None. const function
+ * @return the new book, nullptr if the line was not a valid book
+ */
+Book* BookDatabase::parseBook(string_view line) const
+{
+   return bookFactory.createBook(line);
+}
+
+//-------------------------------------------------------------------------
+/** getShelf()
+ * Shelf of a book
+ *
+ * @param book a book built by parseBook
+ * @pre None
+ * @post None. const function
+ * @return index of the shelf the book goes on
+ */
+int BookDatabase::getShelf(const Book& book) const
+{
+   return bookFactory.getHash(book);
+}
+
+//-------------------------------------------------------------------------
+/** addBook()
+ * Add Method
+ *
+ * Puts a parsed book on its shelf. A duplicate is reported like
+ * insertNewBook reports it and deleted. Only touches the book's shelf,
+ * so books of different shelves can be added from different threads.
+ * @param newBook a book built by parseBook, owned by the database after
+ * @pre None
+ * @post newBook is on its shelf, or deleted if it was a duplicate
+ * @return true if newBook was added
+ */
+bool BookDatabase::addBook(Book* newBook)
+{
    int index = bookFactory.getHash(*newBook);
 
    if (!bookShelf[index]->insert(newBook)) {
-      cout << "BOOK INPUT ERROR (DUPLICATE BOOK): Book titled " << endl
-           << newBook->getTitle().substr(0, TITLE_MAX_LENGTH)
-           << " already exists in this library." << endl;
+      errorOutput() << "BOOK INPUT ERROR (DUPLICATE BOOK): Book titled \n"
+                    << newBook->getTitle().substr(0, TITLE_MAX_LENGTH)
+                    << " already exists in this library.\n";
       delete newBook;
       return false;
    }
+   report[index].valid = false;
+   return true;
+}
+
+//-------------------------------------------------------------------------
+/** stageNewBook()
+ * Stage Method
+ *
+ * Builds a book from the given input and holds it until
+ * commitStagedBooks() is called. Duplicates are not checked here.
+ * @param line one line of book input, parsed in place
+ * @pre None
+ * @post newBook is staged for its shelf, if its input was valid
+ * @return true if the input was a valid book
+ */
+bool BookDatabase::stageNewBook(string_view line)
+{
+   Book* newBook = bookFactory.createBook(line);
+   if (newBook == nullptr) {
+      return false;
+   }
+   int index = bookFactory.getHash(*newBook);
+
+   staged[index].push_back({newBook, stagedCount++});
    return true;
 }
 
+//-------------------------------------------------------------------------
+/** commitStagedBooks()
+ * Bulk Insert Method
+ *
+ * Sorts the staged books of each shelf, merges them with the books
+ * already on the shelf and rebuilds the shelf as a balanced tree in
+ * linear time. When books are equal the one already on the shelf, or
+ * else the one staged first, is kept. Every other copy is reported with
+ * the same DUPLICATE BOOK message insertNewBook prints, followed by a
+ * blank line, in the order the copies were staged, and deleted.
+ * @pre None
+ * @post Staged books are on their shelves. Nothing is staged.
+ * @return number of staged books that were added
+ */
+int BookDatabase::commitStagedBooks()
+{
+   vector<StagedBook> duplicates;
+   int added = 0;
+   BookCompare compare;
+
+   for (int i = 0; i < HASH_SIZE; i++) {
+      vector<StagedBook>& incoming = staged[i];
+      if (incoming.empty()) {
+         continue;
+      }
+
+      // stable, so among equal books the one staged first comes first
+      stable_sort(incoming.begin(), incoming.end(),
+                  [&compare](const StagedBook& a, const StagedBook& b) {
+                     return compare(*a.book, *b.book) < 0;
+                  });
+
+      // books already on the shelf come out sorted as well
+      vector<Book*> shelved(bookShelf[i]->getSize());
+      bookShelf[i]->treeToArray(shelved.data());
+
+      // merge the two sorted runs, dropping anything equal to the last kept
+      vector<Book*> merged;
+      merged.reserve(shelved.size() + incoming.size());
+      size_t next = 0;
+      for (StagedBook& entry : incoming) {
+         while (next < shelved.size() &&
+                compare(*shelved[next], *entry.book) < 0) {
+            merged.push_back(shelved[next++]);
+         }
+         if (next < shelved.size() &&
+             compare(*shelved[next], *entry.book) == 0) {
+            merged.push_back(shelved[next++]);
+         }
+         if (!merged.empty() && compare(*merged.back(), *entry.book) == 0) {
+            duplicates.push_back(entry);
+            continue;
+         }
+         merged.push_back(entry.book);
+         added++;
+      }
+      while (next < shelved.size()) {
+         merged.push_back(shelved[next++]);
+      }
+
+      bookShelf[i]->arrayToTree(merged.data(), (int)merged.size());
+      report[i].valid = false;
+      incoming.clear();
+   }
+
+   sort(duplicates.begin(), duplicates.end(),
+        [](const StagedBook& a, const StagedBook& b) {
+           return a.order < b.order;
+        });
+   for (StagedBook& entry : duplicates) {
+      errorOutput() << "BOOK INPUT ERROR (DUPLICATE BOOK): Book titled \n"
+                    << entry.book->getTitle().substr(0, TITLE_MAX_LENGTH)
+                    << " already exists in this library.\n\n";
+      delete entry.book;
+   }
+
+   stagedCount = 0;
+   return added;
+}
+
 //-------------------------------------------------------------------------
 /** getBook(String bookId)
  * Get Book
@@ -98,22 +280,55 @@ bool BookDatabase::insertNewBook(istream& is)
  */
 Book* BookDatabase::getBook(istream& is) const
 {
-   Book* bookToFind = bookFactory.createBook(is);
-   if (bookToFind == nullptr) {
+   // reused so a lookup only allocates when a line is longer than any before
+   thread_local string line;
+   line.clear();
+   getline(is, line);
+
+   return getBook(string_view(line));
+}
+
+//-------------------------------------------------------------------------
+/** getBook(string_view line)
+ * Get Book by line
+ *
+ * Parses line into a BookKey and looks it up, without building a Book.
+ * Prints the same input and retrieve errors as getBook(istream&).
+ * @param line book line, starting with its type code
+ * @pre None.
+ * @post None. const function
+ * @return the matching Book*, nullptr if the line is bad or not found
+ */
+Book* BookDatabase::getBook(string_view line) const
+{
+   BookKey key;
+   if (!bookFactory.createKey(line, key)) {
       return nullptr;
    }
-   BSTData* bookFound = nullptr;
-
-   int index = bookFactory.getHash(*bookToFind);
-   bookShelf[index]->retrieve(*bookToFind, bookFound);
-   if ((Book*)bookFound == nullptr) {
-      cout << bookToFind->getType() << " BOOK RETRIEVE ERROR: Book titled "
-           << endl
-           << bookToFind->getTitle().substr(0, TITLE_MAX_LENGTH)
-           << " was not found in this library." << endl;
+   return getBook(key);
+}
+
+//-------------------------------------------------------------------------
+/** getBook(const BookKey& key)
+ * Get Book by key
+ *
+ * Searches the key's shelf by heterogeneous comparison and prints the
+ * BOOK RETRIEVE ERROR if the book is not there
+ * @param key a valid key from BookFactory::createKey
+ * @pre None.
+ * @post None. const function
+ * @return the matching Book*, nullptr if not found
+ */
+Book* BookDatabase::getBook(const BookKey& key) const
+{
+   int index = key.typeCode - HASH_START;
+   Book* bookFound = bookShelf[index]->find(key);
+   if (bookFound == nullptr) {
+      errorOutput() << key.type << " BOOK RETRIEVE ERROR: Book titled \n"
+                    << key.title.substr(0, TITLE_MAX_LENGTH)
+                    << " was not found in this library.\n";
    }
-   delete bookToFind;
-   return (Book*)bookFound;
+   return bookFound;
 }
 
 //--------------------------------------------------------------------------
@@ -121,22 +336,164 @@ Book* BookDatabase::getBook(istream& is) const
  *
  * Displays all of the books that have been inserted in the database.
  *
- * The books are printed based on their class memeber variables
+ * The books are printed based on their class memeber variables. With the
+ * report cache on, rows that have not changed are not rendered again
  *
+ * @param os stream the books are written to
  * @pre None.
  * @post None. const function
  */
-void BookDatabase::displayAll() const
+void BookDatabase::displayAll(ostream& os) const
 {
-   for (BSTree* tree : bookShelf) {
+   for (int i = 0; i < HASH_SIZE; i++) {
+      const BookShelf* tree = bookShelf[i];
       if (!tree->isEmpty()) {
-         cout << endl;
+         os << '\n';
 
-         const BSTData* data = tree->getRoot();
-         const Book* book = static_cast<const Book*>(data);
-         book->displayHeader(cout);
-         cout << endl;
+         const Book* book = tree->getRoot();
+         book->displayHeader(os);
+         os << '\n';
+      }
+      if (reportCache) {
+         const string& rows = renderShelf(i);
+         os.write(rows.data(), rows.size());
+         continue;
       }
-      cout << *tree;
+      tree->inorder([&os](const Book* book) {
+         book->display(os);
+         os << '\n';
+      });
    }
+}
+
+//--------------------------------------------------------------------------
+/** setReportCache()
+ * Cached report mode
+ *
+ * With the cache on, displayAll keeps every rendered row and renders a
+ * row again only when its book's count changed or its shelf gained
+ * books. The output is the same either way. On by default.
+ * @param on true to keep rows between displays
+ * @pre None.
+ * @post later displays use the cache or not. Turning it off frees it
+ */
+void BookDatabase::setReportCache(bool on)
+{
+   reportCache = on;
+   if (!on) {
+      for (ShelfReport& shelf : report) {
+         shelf = ShelfReport();
+      }
+   }
+}
+
+//--------------------------------------------------------------------------
+/** renderRow()
+ * Render one report row
+ *
+ * Renders the row in a stream of its own. Book::display sets its own
+ * adjustment and widths, so the row is the bytes displayAll would print.
+ * @param book the book
+ * @pre None.
+ * @post the book is marked as rendered
+ * @return the row followed by a line break
+ */
+static string renderRow(Book& book)
+{
+   thread_local ostringstream row;
+   row.str("");
+   book.display(row);
+   row << '\n';
+   book.clearChanged();
+   return row.str();
+}
+
+//--------------------------------------------------------------------------
+/** renderShelf() const
+ * Rows of one shelf
+ *
+ * Brings the shelf's report up to date, rendering only what changed
+ * @param shelf index of the shelf
+ * @pre the shelf is not being changed
+ * @post the shelf's report matches its books
+ * @return every row of the shelf, as displayAll prints them
+ */
+const string& BookDatabase::renderShelf(int shelf) const
+{
+   ShelfReport& cache = report[shelf];
+   if (cache.valid) {
+      // a row of the same length is overwritten in place. Counts are far
+      // below the width they are printed in, so that is every row
+      for (size_t row = 0; row < cache.books.size(); row++) {
+         Book* book = cache.books[row];
+         if (!book->isChanged()) {
+            continue;
+         }
+         size_t start = cache.starts[row];
+         size_t length = cache.starts[row + 1] - start;
+         string rendered = renderRow(*book);
+         if (rendered.size() != length) {
+            cache.valid = false;
+            break;
+         }
+         cache.text.replace(start, length, rendered);
+      }
+      if (cache.valid) {
+         return cache.text;
+      }
+   }
+
+   cache.books.clear();
+   cache.starts.clear();
+   cache.text.clear();
+   bookShelf[shelf]->inorder([&cache](Book* book) {
+      cache.books.push_back(book);
+      cache.starts.push_back(cache.text.size());
+      cache.text += renderRow(*book);
+   });
+   cache.starts.push_back(cache.text.size());
+   cache.valid = true;
+   return cache.text;
+}
+
+//--------------------------------------------------------------------------
+/** displayStats() const
+ *
+ * Displays one line per non-empty shelf with the number of books, the
+ * height of the shelf's tree and the average comparisons per lookup,
+ * then how many author and title bytes the string pool saved
+ *
+ * @param os stream the statistics are written to
+ * @pre None.
+ * @post None. const function
+ */
+void BookDatabase::displayStats(ostream& os) const
+{
+   ios::fmtflags oldFlags = os.flags();
+   streamsize oldPrecision = os.precision();
+   os << fixed << setprecision(1);
+
+   for (const BookShelf* tree : bookShelf) {
+      if (tree->isEmpty()) {
+         continue;
+      }
+      const Book* book = tree->getRoot();
+      double perLookup = 0;
+      if (tree->getRetrieveCount() > 0) {
+         perLookup = (double)tree->getTotalComparisons() /
+                     tree->getRetrieveCount();
+      }
+      os << book->getType() << " SHELF: " << tree->getSize()
+         << " books, height " << tree->getHeight() << ", " << perLookup
+         << " comparisons per lookup\n";
+   }
+
+   const StringPool& strings = bookFactory.getStrings();
+   os << "STRING POOL: " << strings.getUniqueCount() << " of "
+      << strings.getInternCount() << " names stored, "
+      << strings.getStoredBytes() << " bytes, "
+      << strings.getSavedBytes() << " bytes saved\n";
+
+   os.flags(oldFlags);
+   os.precision(oldPrecision);
 }
\ No newline at end of file
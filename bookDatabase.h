@@ -9,22 +9,42 @@
  *
  * Implementation:
  *   -  Contains an array of pointers to BSTrees, each element reprisents a
- *      hashed value corresponding to booktype
+ *      hashed value corresponding to booktype. Each shelf is a SortedTree
+ *      of Book ordered by BookCompare, so lookups make no virtual calls
  *   -  Uses a "Book Factory" to produce books to insert
+ *   -  Lookups parse the command's book into a BookKey and search the shelf
+ *      with it, no Book is built to search with
+ *   -  Books can also be staged and then committed in one go. Committing
+ *      sorts each shelf's staged books once and rebuilds the shelf as a
+ *      perfectly balanced tree, which is much faster than one insert per
+ *      book for a large catalog
+ *   -  displayAll keeps each shelf's rendered rows between displays. Only
+ *      the rows of books whose count changed are rendered again, and every
+ *      row of a shelf that gained books, so a display of a large catalog is
+ *      mostly one write per shelf
  *
  */
 #ifndef BOOKDATABASE_H
 #define BOOKDATABASE_H
 
+#include "bookKey.h"
 #include "bookfactory.h"
 #include "constants.h"
+#include "sortedTree.h"
+#include <vector>
 
 using namespace std;
 
-class BSTree;
+struct BookCompare;
+
+// one shelf of books of a single type, in that type's order
+typedef SortedTree<Book, BookCompare> BookShelf;
 
 class BookDatabase
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
 public:
    // ------------------------------------------------------------------------
    /** BookDatabase()
@@ -37,6 +57,18 @@ public:
     */
    BookDatabase();
 
+   // ------------------------------------------------------------------------
+   /** BookDatabase(treeOptions)
+    * Constructor with tree options
+    *
+    * Constructs a BookDatabase whose shelves are trees built with the given
+    * options. The default constructor uses TREE_BALANCED | TREE_ARENA.
+    * @param treeOptions TreeOption values combined with |
+    * @pre None.
+    * @post BookDatabase object exists
+    */
+   explicit BookDatabase(int treeOptions);
+
    // ------------------------------------------------------------------------
    /** ~BookDatabase()
     * Destructor
@@ -52,12 +84,80 @@ public:
     * Insert Method
     *
     * Inserts the given book into the correct BST
-    * @param is book input
+    * @param line one line of book input, parsed in place
     * @pre None
     * @post newBook is added to the right BST, if successful
     * @return true if newBook was successfully inserted
     */
-   bool insertNewBook(istream& is);
+   bool insertNewBook(string_view line);
+
+   //-------------------------------------------------------------------------
+   /** parseBook()
+    * Parse Method
+    *
+    * Builds a book from one line without adding it to the database. Input
+    * errors are printed to output(). Only reads the database, so several
+    * threads can parse at once.
+    * @param line one line of book input, parsed in place
+    * @pre None
+    * @post None. const function
+    * @return the new book, nullptr if the line was not a valid book
+    */
+   Book* parseBook(string_view line) const;
+
+   //-------------------------------------------------------------------------
+   /** getShelf()
+    * Shelf of a book
+    *
+    * @param book a book built by parseBook
+    * @pre None
+    * @post None. const function
+    * @return index of the shelf the book goes on
+    */
+   int getShelf(const Book& book) const;
+
+   //-------------------------------------------------------------------------
+   /** addBook()
+    * Add Method
+    *
+    * Puts a parsed book on its shelf. A duplicate is reported like
+    * insertNewBook reports it and deleted. Only touches the book's shelf,
+    * so books of different shelves can be added from different threads.
+    * @param newBook a book built by parseBook, owned by the database after
+    * @pre None
+    * @post newBook is on its shelf, or deleted if it was a duplicate
+    * @return true if newBook was added
+    */
+   bool addBook(Book* newBook);
+
+   //-------------------------------------------------------------------------
+   /** stageNewBook()
+    * Stage Method
+    *
+    * Builds a book from the given input and holds it until
+    * commitStagedBooks() is called. Duplicates are not checked here.
+    * @param line one line of book input, parsed in place
+    * @pre None
+    * @post newBook is staged for its shelf, if its input was valid
+    * @return true if the input was a valid book
+    */
+   bool stageNewBook(string_view line);
+
+   //-------------------------------------------------------------------------
+   /** commitStagedBooks()
+    * Bulk Insert Method
+    *
+    * Sorts the staged books of each shelf, merges them with the books
+    * already on the shelf and rebuilds the shelf as a balanced tree in
+    * linear time. When books are equal the one already on the shelf, or
+    * else the one staged first, is kept. Every other copy is reported with
+    * the same DUPLICATE BOOK message insertNewBook prints, followed by a
+    * blank line, in the order the copies were staged, and deleted.
+    * @pre None
+    * @post Staged books are on their shelves. Nothing is staged.
+    * @return number of staged books that were added
+    */
+   int commitStagedBooks();
 
    //-------------------------------------------------------------------------
    /** getBook(String bookId)
@@ -74,21 +174,117 @@ public:
     */
    Book* getBook(istream& is) const;
 
+   //-------------------------------------------------------------------------
+   /** getBook(string_view line)
+    * Get Book by line
+    *
+    * Parses line into a BookKey and looks it up, without building a Book.
+    * Prints the same input and retrieve errors as getBook(istream&).
+    * @param line book line, starting with its type code
+    * @pre None.
+    * @post None. const function
+    * @return the matching Book*, nullptr if the line is bad or not found
+    */
+   Book* getBook(string_view line) const;
+
+   //-------------------------------------------------------------------------
+   /** getBook(const BookKey& key)
+    * Get Book by key
+    *
+    * Searches the key's shelf by heterogeneous comparison and prints the
+    * BOOK RETRIEVE ERROR if the book is not there
+    * @param key a valid key from BookFactory::createKey
+    * @pre None.
+    * @post None. const function
+    * @return the matching Book*, nullptr if not found
+    */
+   Book* getBook(const BookKey& key) const;
+
    //--------------------------------------------------------------------------
    /** displayAll() const
     *
     * Displays all of the books that have been inserted in the database.
     *
-    * The books are printed based on their class memeber variables
+    * The books are printed based on their class memeber variables. With the
+    * report cache on, rows that have not changed are not rendered again
     *
+    * @param os stream the books are written to
     * @pre None.
     * @post None. const function
     */
-   void displayAll() const;
+   void displayAll(ostream& os) const;
+
+   //--------------------------------------------------------------------------
+   /** setReportCache()
+    * Cached report mode
+    *
+    * With the cache on, displayAll keeps every rendered row and renders a
+    * row again only when its book's count changed or its shelf gained
+    * books. The output is the same either way. On by default.
+    * @param on true to keep rows between displays
+    * @pre None.
+    * @post later displays use the cache or not. Turning it off frees it
+    */
+   void setReportCache(bool on);
+
+   //--------------------------------------------------------------------------
+   /** displayStats() const
+    *
+    * Displays one line per non-empty shelf with the number of books, the
+    * height of the shelf's tree and the average comparisons per lookup,
+    * then how many author and title bytes the string pool saved
+    *
+    * @param os stream the statistics are written to
+    * @pre None.
+    * @post None. const function
+    */
+   void displayStats(ostream& os) const;
 
 private:
+   // a book waiting for commitStagedBooks and the order it was staged in
+   struct StagedBook {
+      Book* book;
+      int order;
+   };
+
+   // rendered rows of one shelf, kept by displayAll between displays
+   struct ShelfReport {
+      // books of the shelf in order, and where each row starts in text,
+      // with text's size last
+      vector<Book*> books;
+      vector<size_t> starts;
+
+      // every row of the shelf, each followed by a line break
+      string text;
+
+      // false until rendered, and again after the shelf gains books
+      bool valid = false;
+   };
+
+   //--------------------------------------------------------------------------
+   /** renderShelf() const
+    * Rows of one shelf
+    *
+    * Brings the shelf's report up to date, rendering only what changed
+    * @param shelf index of the shelf
+    * @pre the shelf is not being changed
+    * @post the shelf's report matches its books
+    * @return every row of the shelf, as displayAll prints them
+    */
+   const string& renderShelf(int shelf) const;
+
    // vector of BSTrees each representing book subclass
-   BSTree* bookShelf[HASH_SIZE];
+   BookShelf* bookShelf[HASH_SIZE];
+
+   // books staged for each shelf, in the order they were staged
+   vector<StagedBook> staged[HASH_SIZE];
+
+   // number of books staged since the last commit
+   int stagedCount;
+
+   // displayAll's rendered rows for each shelf, and whether they are kept
+   mutable ShelfReport report[HASH_SIZE];
+   bool reportCache;
 
    // tool that creates new book objects
    BookFactory bookFactory;
@@ -0,0 +1,43 @@
+/** @file bookKey.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A BookKey holds just the fields that identify a book: its type code,
+ *     author and title, and year and month of publication
+ *   - Can be compared with the books on a shelf (see BookCompare) to find
+ *     a book without building a throwaway Book
+ *
+ * Implementation:
+ *   - author, title and type are string_views into the line the key was
+ *     parsed from, and into the prototype book for type, so the line must
+ *     outlive the key
+ *   - Filled in by BookFactory::createKey, which has each book type parse
+ *     the line exactly like its setData does
+ */
+
+#ifndef BOOKKEY_H
+#define BOOKKEY_H
+
+#include <string_view>
+
+using namespace std;
+
+struct BookKey {
+   // book type code, FICTION_CODE, CHILDREN_CODE or PERIODICAL_CODE
+   char typeCode = 0;
+
+   // book type name, as Book::getType returns it
+   string_view type;
+
+   // author of book, empty for periodicals
+   string_view author;
+
+   // title of book
+   string_view title;
+
+   // year and month book was published, 0 when not given
+   int year = 0;
+   int month = 0;
+};
+
+#endif
@@ -15,13 +15,19 @@
  *     string data.
  *   - Classifies each type of book and creates the correct sub-class of
  *     book for each string passed in.
+ *   - Can also parse a line into a BookKey, for looking a book up without
+ *     creating one.
+ *   - Keeps the author and title of every book it creates in its
+ *     StringPool, so the factory must outlive its books.
  */
 
 #include "bookfactory.h"
 #include "book.h"
 #include "children.h"
 #include "constants.h"
+#include "fieldReader.h"
 #include "fiction.h"
+#include "outputSink.h"
 #include "periodical.h"
 #include <iostream>
 
@@ -74,25 +80,34 @@ BookFactory::~BookFactory()
  */
 Book* BookFactory::createBook(istream& is) const
 {
-   char type = is.get();
+   // reused so reading a line does not allocate once it has grown
+   thread_local string line;
+   getline(is, line);
+   return createBook(line);
+}
 
-   string line;
-   int index = type - HASH_START;
-   if (index < 0 || index >= HASH_SIZE) { // ERROR
-      cout << "BOOK INPUT ERROR: not a recognized type." << endl;
-      getline(is, line);
-      return nullptr; // character is out of range
-   }
-   if (bookTypes[index] == nullptr) { // ERROR
-      cout << "BOOK INPUT ERROR: " << type << " is not a recognized type."
-           << endl;
-      getline(is, line);
-      return nullptr; // no booktype exists
+// -------------------------------------------------------------------------
+/** createBook()
+ * Builder Function
+ *
+ * Same as createBook(istream&) for a line already in memory. The line is
+ * parsed in place, no stream or copy of the line is made.
+ * @param line the book's line, starting with its type code
+ * @pre None.
+ * @post Book pointer.
+ * @return the new Book, nullptr if the line was not valid
+ */
+Book* BookFactory::createBook(string_view line) const
+{
+   FieldReader in(line);
+   const Book* prototype = getPrototype(in);
+   if (prototype == nullptr) {
+      return nullptr;
    }
 
-   Book* newBook = bookTypes[index]->create();
+   Book* newBook = prototype->create();
 
-   if (!newBook->setData(is)) { // improper input
+   if (!newBook->setData(in, strings)) { // improper input
       delete newBook;
       return nullptr;
    }
@@ -100,11 +115,65 @@ Book* BookFactory::createBook(istream& is) const
    return newBook;
 }
 
+// -------------------------------------------------------------------------
+/** createKey()
+ * Key Builder Function
+ *
+ * Reads the same line createBook reads, with the same checks and error
+ * messages, into a BookKey. No Book is built and nothing is allocated,
+ * the key's fields point into line.
+ * @param line the book's line, starting with its type code
+ * @param key set to the book's identifying fields
+ * @pre line outlives key
+ * @post key holds the book's fields if the line was valid
+ * @return true if the line was valid
+ */
+bool BookFactory::createKey(string_view line, BookKey& key) const
+{
+   FieldReader in(line);
+   const Book* prototype = getPrototype(in);
+   if (prototype == nullptr) {
+      return false;
+   }
+
+   return prototype->parseKey(in, key);
+}
+
+// -------------------------------------------------------------------------
+/** getPrototype()
+ * find book type
+ *
+ * Reads the type code and returns the prototype of that type, printing
+ * the type error createBook and createKey print if there is none
+ * @param in reader at the start of the line
+ * @pre None
+ * @post the type code is read
+ * @return the prototype book, nullptr if the type is not recognized
+ */
+const Book* BookFactory::getPrototype(FieldReader& in) const
+{
+   char type = in.get();
+
+   int index = type - HASH_START;
+   if (index < 0 || index >= HASH_SIZE) { // ERROR
+      errorOutput() << "BOOK INPUT ERROR: not a recognized type.\n";
+      return nullptr; // character is out of range
+   }
+   if (bookTypes[index] == nullptr) { // ERROR
+      errorOutput() << "BOOK INPUT ERROR: " << type
+                    << " is not a recognized type.\n";
+      return nullptr; // no booktype exists
+   }
+
+   return bookTypes[index];
+}
+
 // -------------------------------------------------------------------------
 /** getHash()
  * get hash
  *
- * turn the type of book into a hash key.
+ * turn the type code of book into its index in bookTypes and the
+ * shelves. No string is read or copied.
  * @param book the book that we want to get the key for
  * @pre None
  * @post None
@@ -112,6 +181,5 @@ Book* BookFactory::createBook(istream& is) const
  */
 int BookFactory::getHash(const Book& book) const
 {
-   string type = book.getType();
-   return type[0] - HASH_START;
+   return book.getTypeCode() - HASH_START;
 }
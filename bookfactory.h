@@ -14,19 +14,31 @@
  *     string data.
  *   - Classifies each type of book and creates the correct sub-class of
  *     book for each string passed in.
+ *   - Can also parse a line into a BookKey, for looking a book up without
+ *     creating one.
+ *   - Keeps the author and title of every book it creates in its
+ *     StringPool, so the factory must outlive its books.
  */
 
 #ifndef BOOKFACTORY_H
 #define BOOKFACTORY_H
 
 #include "book.h"
+#include "bookKey.h"
 #include "constants.h"
+#include "stringPool.h"
 #include <iostream>
+#include <string_view>
 
 using namespace std;
 
+class FieldReader;
+
 class BookFactory
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
 public:
    // -------------------------------------------------------------------------
    /** BookFactory()
@@ -62,11 +74,50 @@ public:
     */
    Book* createBook(istream& is) const;
 
+   // -------------------------------------------------------------------------
+   /** createBook()
+    * Builder Function
+    *
+    * Same as createBook(istream&) for a line already in memory. The line is
+    * parsed in place, no stream or copy of the line is made.
+    * @param line the book's line, starting with its type code
+    * @pre None.
+    * @post Book pointer.
+    * @return the new Book, nullptr if the line was not valid
+    */
+   Book* createBook(string_view line) const;
+
+   // -------------------------------------------------------------------------
+   /** createKey()
+    * Key Builder Function
+    *
+    * Reads the same line createBook reads, with the same checks and error
+    * messages, into a BookKey. No Book is built and nothing is allocated,
+    * the key's fields point into line.
+    * @param line the book's line, starting with its type code
+    * @param key set to the book's identifying fields
+    * @pre line outlives key
+    * @post key holds the book's fields if the line was valid
+    * @return true if the line was valid
+    */
+   bool createKey(string_view line, BookKey& key) const;
+
+   // -------------------------------------------------------------------------
+   /** getStrings()
+    * Author and title pool
+    *
+    * @pre None
+    * @post None
+    * @return the pool the created books keep their author and title in
+    */
+   const StringPool& getStrings() const { return strings; }
+
    // -------------------------------------------------------------------------
    /** getHash()
     * get hash
     *
-    * turn the type of book into a hash key.
+    * turn the type code of book into its index in bookTypes and the
+    * shelves. No string is read or copied.
     * @param book the book that we want to get the key for
     * @pre None
     * @post None
@@ -87,6 +138,23 @@ public:
    string getType(char type) const; */
 
 private:
+   // -------------------------------------------------------------------------
+   /** getPrototype()
+    * find book type
+    *
+    * Reads the type code and returns the prototype of that type, printing
+    * the type error createBook and createKey print if there is none
+    * @param in reader at the start of the line
+    * @pre None
+    * @post the type code is read
+    * @return the prototype book, nullptr if the type is not recognized
+    */
+   const Book* getPrototype(FieldReader& in) const;
+
+   // author and title of every book created. Interning does not change what
+   // the factory creates, so createBook can stay const
+   mutable StringPool strings;
+
    // Array of subclasses of Book object to classify each book as its correct
    //  type.
    const Book* bookTypes[HASH_SIZE]{};
@@ -12,8 +12,11 @@
 #include "checkoutBook.h"
 #include "book.h"
 #include "constants.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include "patron.h"
 #include <iostream>
+#include <new>
 
 using namespace std;
 
@@ -45,30 +48,33 @@ CheckoutBook::CheckoutBook(BookDatabase* books, PatronDatabase* patrons)
  */
 bool CheckoutBook::execute()
 {
-
+   Metrics::Timer timer(METRIC_CHECKOUT);
    if (!book->removeBook()) {
-      cout << "CHECKOUT COMMAND EXECUTION ERROR (for patron "
-           << patron->getID() << "): " << endl
-           << "Can't checkout book. Library contains no books left titled:"
-           << endl
-           << book->getTitle() << endl;
-      delete this;
+      Metrics::countError(ERROR_NO_COPIES);
+      errorOutput() << "CHECKOUT COMMAND EXECUTION ERROR (for patron "
+                    << patron->getID() << "): \n"
+                    << "Can't checkout book. Library contains no books left "
+                  "titled:\n"
+                    << book->getTitle() << '\n';
+      release();
       return false;
    }
    patron->addBook(book);
-   patron->addCommand(this); // if all functions successfull, store command
+   // if all functions successfull, store command in the patron's history
+   patron->addHistory(commandCode, book, sequence);
+   release();
    return true;
 }
 
 /** create()
  * Create Library Command (factory)
  *
- * Create a library command of the appropriate type
- * this function is pure virtual
- * @pre None
- * @post a new library command exists
+ * Create a library command of the appropriate type in slot
+ * @param slot storage for the command, from the factory's CommandPool
+ * @pre slot is big enough for a CheckoutBook
+ * @post a new library command exists in slot
  */
-LibraryCommand* CheckoutBook::create() const
+LibraryCommand* CheckoutBook::create(void* slot) const
 {
-   return new CheckoutBook(bookDB, patronDB);
+   return new (slot) CheckoutBook(bookDB, patronDB);
 }
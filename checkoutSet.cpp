@@ -0,0 +1,252 @@
+/** @file checkoutSet.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A CheckoutSet holds the books a patron has checked out and how many
+ *     copies of each
+ *   - Only books with at least one copy out are held. Returning the last
+ *     copy removes the book, and a failed return changes nothing
+ *
+ * Implementation:
+ *   - The first INLINE_COUNT books are kept in an array inside the set, so
+ *     a patron with a handful of books makes no heap allocation at all
+ *   - Books past that go in an unordered_map, allocated the first time a
+ *     patron holds more than INLINE_COUNT books. Every book is in exactly
+ *     one of the two
+ *   - A book removed from the array is replaced by the last entry of the
+ *     array, so the array has no holes
+ */
+
+#include "checkoutSet.h"
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** CheckoutSet()
+ * Default Constructor
+ *
+ * @pre None.
+ * @post set is empty and has allocated nothing
+ */
+CheckoutSet::CheckoutSet()
+{
+   count = 0;
+   overflow = nullptr;
+}
+
+// -------------------------------------------------------------------------
+/** CheckoutSet(other)
+ * Copy Constructor
+ *
+ * @param other set to copy
+ * @pre None.
+ * @post set holds the same books and copies as other
+ */
+CheckoutSet::CheckoutSet(const CheckoutSet& other)
+{
+   count = 0;
+   overflow = nullptr;
+   *this = other;
+}
+
+// -------------------------------------------------------------------------
+/** ~CheckoutSet()
+ * Destructor
+ *
+ * @pre None.
+ * @post the overflow map, if any, is freed
+ */
+CheckoutSet::~CheckoutSet() { delete overflow; }
+
+// -------------------------------------------------------------------------
+/** operator=()
+ * Copy assignment operator
+ *
+ * @param rhs set to copy
+ * @pre None.
+ * @post set holds the same books and copies as rhs
+ * @return reference to this set
+ */
+CheckoutSet& CheckoutSet::operator=(const CheckoutSet& rhs)
+{
+   if (this != &rhs) {
+      count = rhs.count;
+      for (int i = 0; i < count; i++) {
+         entries[i] = rhs.entries[i];
+      }
+      if (rhs.overflow == nullptr) {
+         delete overflow;
+         overflow = nullptr;
+      } else if (overflow == nullptr) {
+         overflow = new unordered_map<const Book*, int>(*rhs.overflow);
+      } else {
+         *overflow = *rhs.overflow;
+      }
+   }
+
+   return *this;
+}
+
+// -------------------------------------------------------------------------
+/** add()
+ * Check out one copy
+ *
+ * @param book the book
+ * @pre None.
+ * @post one more copy of book is held
+ */
+void CheckoutSet::add(const Book* book)
+{
+   int index = find(book);
+   if (index >= 0) {
+      entries[index].copies++;
+      return;
+   }
+   if (overflow != nullptr) {
+      auto found = overflow->find(book);
+      if (found != overflow->end()) {
+         found->second++;
+         return;
+      }
+   }
+   set(book, 1);
+}
+
+// -------------------------------------------------------------------------
+/** remove()
+ * Return one copy
+ *
+ * @param book the book
+ * @pre None.
+ * @post one less copy of book is held. A book with no copies left is no
+ * longer in the set
+ * @return false if no copy of book was held, set unchanged
+ */
+bool CheckoutSet::remove(const Book* book)
+{
+   int index = find(book);
+   if (index >= 0) {
+      if (--entries[index].copies == 0) {
+         erase(index);
+      }
+      return true;
+   }
+   if (overflow == nullptr) {
+      return false;
+   }
+   auto found = overflow->find(book);
+   if (found == overflow->end()) {
+      return false;
+   }
+   if (--found->second == 0) {
+      overflow->erase(found);
+   }
+   return true;
+}
+
+// -------------------------------------------------------------------------
+/** set()
+ * Set the copies of a book
+ *
+ * @param book the book
+ * @param copies copies held, a book with none is removed
+ * @pre None.
+ * @post copiesOf(book) is copies, or 0 if copies is negative
+ */
+void CheckoutSet::set(const Book* book, int copies)
+{
+   int index = find(book);
+   if (index >= 0) {
+      if (copies > 0) {
+         entries[index].copies = copies;
+      } else {
+         erase(index);
+      }
+      return;
+   }
+   if (copies <= 0) {
+      if (overflow != nullptr) {
+         overflow->erase(book);
+      }
+      return;
+   }
+   if (overflow != nullptr && overflow->count(book) > 0) {
+      (*overflow)[book] = copies;
+   } else if (count < INLINE_COUNT) {
+      entries[count++] = Entry{book, copies};
+   } else {
+      if (overflow == nullptr) {
+         overflow = new unordered_map<const Book*, int>();
+      }
+      (*overflow)[book] = copies;
+   }
+}
+
+// -------------------------------------------------------------------------
+/** copiesOf()
+ * Copies of a book held
+ *
+ * @param book the book
+ * @pre None.
+ * @post None. const
+ * @return copies of book held, 0 if none
+ */
+int CheckoutSet::copiesOf(const Book* book) const
+{
+   int index = find(book);
+   if (index >= 0) {
+      return entries[index].copies;
+   }
+   if (overflow != nullptr) {
+      auto found = overflow->find(book);
+      if (found != overflow->end()) {
+         return found->second;
+      }
+   }
+   return 0;
+}
+
+// -------------------------------------------------------------------------
+/** size()
+ * Books held
+ *
+ * @pre None.
+ * @post None. const
+ * @return number of different books held
+ */
+int CheckoutSet::size() const
+{
+   return count + (overflow == nullptr ? 0 : (int)overflow->size());
+}
+
+// -------------------------------------------------------------------------
+/** find()
+ * Position of a book in the array
+ *
+ * @param book the book
+ * @pre None.
+ * @post None. const
+ * @return index in entries, -1 if the book is not in the array
+ */
+int CheckoutSet::find(const Book* book) const
+{
+   for (int i = 0; i < count; i++) {
+      if (entries[i].book == book) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+// -------------------------------------------------------------------------
+/** erase()
+ * Remove an array entry
+ *
+ * @param index position of the entry
+ * @pre 0 <= index < count
+ * @post the entry is gone, the last entry takes its place
+ */
+void CheckoutSet::erase(int index)
+{
+   entries[index] = entries[--count];
+}
@@ -0,0 +1,186 @@
+/** @file checkoutSet.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A CheckoutSet holds the books a patron has checked out and how many
+ *     copies of each
+ *   - Only books with at least one copy out are held. Returning the last
+ *     copy removes the book, and a failed return changes nothing
+ *
+ * Implementation:
+ *   - The first INLINE_COUNT books are kept in an array inside the set, so
+ *     a patron with a handful of books makes no heap allocation at all
+ *   - Books past that go in an unordered_map, allocated the first time a
+ *     patron holds more than INLINE_COUNT books. Every book is in exactly
+ *     one of the two
+ *   - A book removed from the array is replaced by the last entry of the
+ *     array, so the array has no holes
+ */
+
+#ifndef CHECKOUTSET_H
+#define CHECKOUTSET_H
+
+#include <unordered_map>
+
+using namespace std;
+
+class Book;
+
+class CheckoutSet
+{
+public:
+   // -------------------------------------------------------------------------
+   /** CheckoutSet()
+    * Default Constructor
+    *
+    * @pre None.
+    * @post set is empty and has allocated nothing
+    */
+   CheckoutSet();
+
+   // -------------------------------------------------------------------------
+   /** CheckoutSet(other)
+    * Copy Constructor
+    *
+    * @param other set to copy
+    * @pre None.
+    * @post set holds the same books and copies as other
+    */
+   CheckoutSet(const CheckoutSet& other);
+
+   // -------------------------------------------------------------------------
+   /** ~CheckoutSet()
+    * Destructor
+    *
+    * @pre None.
+    * @post the overflow map, if any, is freed
+    */
+   ~CheckoutSet();
+
+   // -------------------------------------------------------------------------
+   /** operator=()
+    * Copy assignment operator
+    *
+    * @param rhs set to copy
+    * @pre None.
+    * @post set holds the same books and copies as rhs
+    * @return reference to this set
+    */
+   CheckoutSet& operator=(const CheckoutSet& rhs);
+
+   // -------------------------------------------------------------------------
+   /** add()
+    * Check out one copy
+    *
+    * @param book the book
+    * @pre None.
+    * @post one more copy of book is held
+    */
+   void add(const Book* book);
+
+   // -------------------------------------------------------------------------
+   /** remove()
+    * Return one copy
+    *
+    * @param book the book
+    * @pre None.
+    * @post one less copy of book is held. A book with no copies left is no
+    * longer in the set
+    * @return false if no copy of book was held, set unchanged
+    */
+   bool remove(const Book* book);
+
+   // -------------------------------------------------------------------------
+   /** set()
+    * Set the copies of a book
+    *
+    * @param book the book
+    * @param copies copies held, a book with none is removed
+    * @pre None.
+    * @post copiesOf(book) is copies, or 0 if copies is negative
+    */
+   void set(const Book* book, int copies);
+
+   // -------------------------------------------------------------------------
+   /** copiesOf()
+    * Copies of a book held
+    *
+    * @param book the book
+    * @pre None.
+    * @post None. const
+    * @return copies of book held, 0 if none
+    */
+   int copiesOf(const Book* book) const;
+
+   // -------------------------------------------------------------------------
+   /** size()
+    * Books held
+    *
+    * @pre None.
+    * @post None. const
+    * @return number of different books held
+    */
+   int size() const;
+
+   // -------------------------------------------------------------------------
+   /** forEach()
+    * Visit every book held
+    *
+    * Calls visit(book, copies) once per book, in no particular order
+    * @param visit callable taking a const Book* and an int
+    * @pre visit does not change the set
+    * @post None. const
+    */
+   template <class Visit>
+   void forEach(Visit visit) const
+   {
+      for (int i = 0; i < count; i++) {
+         visit(entries[i].book, entries[i].copies);
+      }
+      if (overflow != nullptr) {
+         for (const auto& entry : *overflow) {
+            visit(entry.first, entry.second);
+         }
+      }
+   }
+
+private:
+   // books held inside the set before the overflow map is used
+   static const int INLINE_COUNT = 4;
+
+   // one book and its copies
+   struct Entry {
+      const Book* book;
+      int copies;
+   };
+
+   // the first books, entries[0] to entries[count - 1] are in use
+   Entry entries[INLINE_COUNT];
+   int count;
+
+   // books past INLINE_COUNT, nullptr until the first one
+   unordered_map<const Book*, int>* overflow;
+
+   // -------------------------------------------------------------------------
+   /** find()
+    * Position of a book in the array
+    *
+    * @param book the book
+    * @pre None.
+    * @post None. const
+    * @return index in entries, -1 if the book is not in the array
+    */
+   int find(const Book* book) const;
+
+   // -------------------------------------------------------------------------
+   /** erase()
+    * Remove an array entry
+    *
+    * @param index position of the entry
+    * @pre 0 <= index < count
+    * @post the entry is gone, the last entry takes its place
+    */
+   void erase(int index);
+};
+
+#endif
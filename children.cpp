@@ -11,9 +11,10 @@
 #include "children.h"
 #include "BSTData.h"
 #include "book.h"
+#include "bookKey.h"
+#include "fieldReader.h"
+#include "outputSink.h"
 #include <iomanip>
-#include <regex>
-#include <sstream>
 #include <string>
 
 using namespace std;
@@ -47,26 +48,6 @@ Children::~Children() {}
  */
 Book* Children::create() const { return new Children(); }
 
-// -------------------------------------------------------------------------
-/** compare()
- * Compare children books
- *
- * Compare 2 children books. Returns an integer that reflects the comparison
- * @param rhs Book to be compared
- * @pre None
- * @post new children book object exists
- * @return negative int if left book < right.
- * return 0 if equal, return positive int if left > right
- */
-int Children::compare(const Children& rhs) const
-{
-   int compare = title.compare(rhs.title);
-   if (compare == 0) {
-      compare = author.compare(rhs.author);
-   }
-   return compare;
-}
-
 // -------------------------------------------------------------------------
 /** operator<()
  * Operator less than overload
@@ -169,7 +150,9 @@ bool Children::operator>=(const BSTData& rhs) const
 /** operator=()
  * Copy assignment operator
  *
- * Copy data from right hand item to left hand item.
+ * Copy data from right hand item to left hand item. The author and title
+ * are copied into storage this book owns, so it does not depend on rhs or
+ * its factory's pool.
  * @param rhs Book who's data will be duplicated
  * @pre Items should not be the same item
  * @post left item contains data from rhs, right item is const
@@ -179,62 +162,62 @@ BSTData& Children::operator=(const BSTData& rhs)
 {
    const Children& right = static_cast<const Children&>(rhs);
    if (this != &right) {
-      author = right.author;
-      title = right.title;
+      setNames(right.author, right.title);
       year = right.year;
    }
    return *this;
 }
 
 // -------------------------------------------------------------------------
-/** setData()
- * input data into node
+/** parseKey()
+ * Parse a book key
  *
- * Take data from inputStream and put into node members
- * @param is stream line of data for book
- * @pre must have a properly formatted input file
- * @post line of input is read. BSTData contains line data
- * @return true if line of data was read, false if no line or bad format
+ * Parses the rest of a book line with the book's checks and error
+ * messages. Book::setData and BookFactory::createKey both use it
+ * @param in the rest of the line after the type code
+ * @param key set to the book's identifying fields
+ * @pre None
+ * @post the line is read. key holds its data if it was valid
+ * @return true if the line was valid, false if bad format
  */
-bool Children::setData(istream& is)
+bool Children::parseKey(FieldReader& in, BookKey& key) const
 {
-   string line;
-   is.get();
-   char form = is.get();
-   if (is.peek() == ' ') {
+   string_view line;
+   key.typeCode = typeCode;
+   key.type = type;
+
+   in.get();
+   char form = in.get();
+   if (in.peek() == ' ') {
       if (form != format) {
-         cout << type << " BOOK INPUT ERROR: " << form
-              << " is not a recognized format." << endl;
-         getline(is, line);
+         errorOutput() << type << " BOOK INPUT ERROR: " << form
+                       << " is not a recognized format.\n";
          return false;
       }
-      is.get();
+      in.get();
    } else {
-      is.unget();
+      in.unget();
    }
-   stringstream data;
-   getline(is, line);
-   data.str(line);
-   string s1 = "";
-   string s2 = "";
-   getline(data, s1, ',');
+   in.rest(line);
+   FieldReader data(line);
+   string_view s1 = "";
+   string_view s2 = "";
+   data.getline(s1, ',');
    data.get();
-   getline(data, s2, ',');
-   data >> year;
-
-   if (year) { // book
-
-      author = s1;
-      title = s2;
+   data.getline(s2, ',');
+   data.readInt(key.year);
 
+   if (key.year) { // book
+      key.author = s1;
+      key.title = s2;
    } else { // command
-      title = s1;
-      author = s2;
+      key.title = s1;
+      key.author = s2;
    }
-   if (year < 0) {
-      cout << TYPE_CHILDREN << " BOOK INPUT ERROR: For book titled" << endl
-           << title.substr(0, TITLE_MAX_LENGTH) << ","
-           << " year " << year << " is not a valid year." << endl;
+   if (key.year < 0) {
+      errorOutput() << TYPE_CHILDREN << " BOOK INPUT ERROR: For book titled\n"
+                    << key.title.substr(0, TITLE_MAX_LENGTH) << ","
+                    << " year " << key.year << " is not a valid year.\n";
       return false;
    }
 
@@ -298,7 +281,7 @@ ostream& Children::displayHeader(ostream& os) const
 {
    os.setf(ios::left, ios::adjustfield);
 
-   os << type << " BOOKS" << endl;
+   os << type << " BOOKS\n";
    os << setw(COUNT_BUFFER) << "AVAIL" << setw(TITLE_BUFFER) << "TITLE"
       << setw(AUTHOR_BUFFER) << "AUTHOR" << setw(YEAR_BUFFER) << "YEAR";
 
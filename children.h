@@ -12,6 +12,7 @@
 #define CHILDREN_H
 
 #include "book.h"
+#include "bookKey.h"
 #include "constants.h"
 #include <string>
 
@@ -123,7 +124,9 @@ public:
    /** operator=()
     * Copy assignment operator
     *
-    * Copy data from right hand item to left hand item.
+    * Copy data from right hand item to left hand item. The author and title
+    * are copied into storage this book owns, so it does not depend on rhs or
+    * its factory's pool.
     * @param rhs Book who's data will be duplicated
     * @pre Items should not be the same item
     * @post left item contains data from rhs, right item is const
@@ -131,18 +134,6 @@ public:
     */
    virtual BSTData& operator=(const BSTData& rhs);
 
-   // -------------------------------------------------------------------------
-   /** setData()
-    * input data into node
-    *
-    * Take data from inputStream and put into node members
-    * @param is stream line of data for book
-    * @pre must have a properly formatted input file
-    * @post line of input is read. BSTData contains line data
-    * @return true if line of data was read, false if no line or bad format
-    */
-   virtual bool setData(istream& is);
-
    // -------------------------------------------------------------------------
    /** display()
     * Display book information
@@ -181,7 +172,33 @@ public:
     */
    virtual ostream& displayHeader(ostream&) const;
 
-private:
+   // -------------------------------------------------------------------------
+   /** parseKey()
+    * Parse a book key
+    *
+    * Parses the rest of a book line with the book's checks and error
+    * messages. Book::setData and BookFactory::createKey both use it
+    * @param in the rest of the line after the type code
+    * @param key set to the book's identifying fields
+    * @pre None
+    * @post the line is read. key holds its data if it was valid
+    * @return true if the line was valid, false if bad format
+    */
+   virtual bool parseKey(FieldReader& in, BookKey& key) const;
+
+   // -------------------------------------------------------------------------
+   /** compareKey()
+    * Compare a key with this book
+    *
+    * Same ordering as compare(), with the key on the left
+    * @param key key to be compared, of this book's type
+    * @pre None
+    * @post None. const
+    * @return negative int if key < this book.
+    * return 0 if equal, return positive int if key > this book
+    */
+   int compareKey(const BookKey& key) const;
+
    // -------------------------------------------------------------------------
    /** compare()
     * Compare children books
@@ -195,8 +212,32 @@ private:
     */
    int compare(const Children& rhs) const;
 
+private:
    // current patrons checking out the book. max size is maxCount
    Patron* checkouts[5];
 };
 
+// inline so BookCompare can inline it into shelf lookups. Views of the
+// same text are equal without comparing the text
+inline int Children::compare(const Children& rhs) const
+{
+   int compare = 0;
+   if (!sameView(title, rhs.title)) {
+      compare = title.compare(rhs.title);
+   }
+   if (compare == 0 && !sameView(author, rhs.author)) {
+      compare = author.compare(rhs.author);
+   }
+   return compare;
+}
+
+inline int Children::compareKey(const BookKey& key) const
+{
+   int compare = key.title.compare(title);
+   if (compare == 0) {
+      compare = key.author.compare(author);
+   }
+   return compare;
+}
+
 #endif
\ No newline at end of file
@@ -9,15 +9,23 @@
  *   - If the factory is destroyed, nothing else is deleted with it
  *   - Fetches the command to be made using CommandTypeHashmap
  *   - Delegates initializing a command to the command object.
+ *   - Every command is built in a CommandPool kept for its type and ends
+ *     with LibraryCommand::release(), so making and ending commands does
+ *     not touch the heap once the pools have grown. The factory must
+ *     outlive every command it made.
  */
 
 #include "commandFactory.h"
 
 #include "checkoutBook.h"
+#include "commandPool.h"
 #include "constants.h"
 #include "displayLibrary.h"
 #include "displayPatronHistory.h"
+#include "fieldReader.h"
 #include "libraryCommand.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include "returnBook.h"
 #include <forward_list>
 #include <iostream>
@@ -45,14 +53,21 @@ CommandFactory::CommandFactory(BookDatabase* books, PatronDatabase* patrons)
        new DisplayLibrary(books, patrons);
    commandTypes[DISPLAY_PAT_CODE - HASH_START] =
        new DisplayPatronHistory(books, patrons);
+
+   pools[CHECKOUT_CODE - HASH_START] = new CommandPool(sizeof(CheckoutBook));
+   pools[RETURN_CODE - HASH_START] = new CommandPool(sizeof(ReturnBook));
+   pools[DISPLAY_LIB_CODE - HASH_START] =
+       new CommandPool(sizeof(DisplayLibrary));
+   pools[DISPLAY_PAT_CODE - HASH_START] =
+       new CommandPool(sizeof(DisplayPatronHistory));
 }
 
 // -------------------------------------------------------------------------
 /** ~CommandFactory
  * Command Factory Destructor
  *
- * Destroys the CommandFactory
- * @pre None
+ * Destroys the CommandFactory and its command pools
+ * @pre every command the factory made was released
  * @post Returns CommandFactory to memory, nothing else
  */
 CommandFactory::~CommandFactory()
@@ -62,6 +77,9 @@ CommandFactory::~CommandFactory()
          delete comm;
       }
    }
+   for (CommandPool* pool : pools) {
+      delete pool;
+   }
 }
 
 // -------------------------------------------------------------------------
@@ -76,30 +94,68 @@ CommandFactory::~CommandFactory()
  * @return A filled CommandQueue object
  */
 LibraryCommand* CommandFactory::createCommand(istream& is)
+{
+   // reused so reading a line does not allocate once it has grown
+   thread_local string line;
+   line.clear();
+   getline(is, line);
+   return createCommand(string_view(line));
+}
+
+// -------------------------------------------------------------------------
+/** createCommand()
+ * Create Command
+ *
+ * Same as createCommand(istream&) for a line already in memory. The
+ * line is parsed in place, no stream or copy of it is made.
+ * @param line one command line, starting with its type code
+ * @pre None.
+ * @post Library unchanged.
+ * @return the new command, nullptr if the line was not valid
+ */
+LibraryCommand* CommandFactory::createCommand(string_view line)
 {
    LibraryCommand* comm = nullptr;
-   char type = is.get();
-   string line;
+   FieldReader in(line);
+   char type = in.get();
    int index = type - HASH_START;
    if (index < 0 || index >= HASH_SIZE) { // ERROR
-      cout << "COMMAND INPUT ERROR: Command type " << type
-           << " does not exist." << endl;
-      getline(is, line);
+      Metrics::countError(ERROR_UNKNOWN_COMMAND);
+      errorOutput() << "COMMAND INPUT ERROR: Command type " << type
+                    << " does not exist.\n";
       return nullptr; // character is out of range
    }
    if (commandTypes[index] == nullptr) { // ERROR
-      cout << "COMMAND INPUT ERROR: Command type " << type
-           << " does not exist." << endl;
-      getline(is, line);
+      Metrics::countError(ERROR_UNKNOWN_COMMAND);
+      errorOutput() << "COMMAND INPUT ERROR: Command type " << type
+                    << " does not exist.\n";
       return nullptr; // no command type doesnt exist
    }
-   comm = commandTypes[index]->create();
+   comm = newCommand(index);
 
-   is.get();
-   if (!comm->initialize(is)) {
-      delete comm;
+   in.get();
+   if (!comm->initialize(in)) {
+      comm->release();
       return nullptr;
    }
+   comm->sequence = nextSequence++;
+
+   return comm;
+}
 
+// -------------------------------------------------------------------------
+/** newCommand()
+ * Build an empty command
+ *
+ * @param index type code less HASH_START, of an existing command type
+ * @pre commandTypes[index] is not nullptr
+ * @post the command takes a slot from pools[index] until it is released
+ * @return the new command, not yet initialized
+ */
+LibraryCommand* CommandFactory::newCommand(int index)
+{
+   CommandPool* pool = pools[index];
+   LibraryCommand* comm = commandTypes[index]->create(pool->allocate());
+   comm->pool = pool;
    return comm;
 }
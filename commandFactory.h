@@ -9,23 +9,33 @@
  *   - If the factory is destroyed, nothing else is deleted with it
  *   - Fetches the command to be made using CommandTypeHashmap
  *   - Delegates initializing a command to the command object.
+ *   - Every command is built in a CommandPool kept for its type and ends
+ *     with LibraryCommand::release(), so making and ending commands does
+ *     not touch the heap once the pools have grown. The factory must
+ *     outlive every command it made.
  */
 
 #ifndef COMMANDFACTORY_H
 #define COMMANDFACTORY_H
 
 #include "constants.h"
+#include <cstdint>
 #include <iostream>
+#include <string_view>
 
 using namespace std;
 
 class BookDatabase;
 class PatronDatabase;
+class CommandPool;
 class CommandQueue;
 class LibraryCommand;
 
 class CommandFactory
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
 public:
    // -------------------------------------------------------------------------
    /** CommandFactory
@@ -43,8 +53,8 @@ public:
    /** ~CommandFactory
     * Command Factory Destructor
     *
-    * Destroys the CommandFactory
-    * @pre None
+    * Destroys the CommandFactory and its command pools
+    * @pre every command the factory made was released
     * @post Returns CommandFactory to memory, nothing else
     */
    ~CommandFactory();
@@ -62,6 +72,19 @@ public:
     */
    LibraryCommand* createCommand(istream& is);
 
+   // -------------------------------------------------------------------------
+   /** createCommand()
+    * Create Command
+    *
+    * Same as createCommand(istream&) for a line already in memory. The
+    * line is parsed in place, no stream or copy of it is made.
+    * @param line one command line, starting with its type code
+    * @pre None.
+    * @post Library unchanged.
+    * @return the new command, nullptr if the line was not valid
+    */
+   LibraryCommand* createCommand(string_view line);
+
 private:
    BookDatabase* bookDB;
 
@@ -69,6 +92,23 @@ private:
 
    // hash-map to determine command type to build
    const LibraryCommand* commandTypes[HASH_SIZE]{};
+
+   // storage for the commands of each type, same index as commandTypes
+   CommandPool* pools[HASH_SIZE]{};
+
+   // sequence number of the next command made
+   uint32_t nextSequence = 0;
+
+   // -------------------------------------------------------------------------
+   /** newCommand()
+    * Build an empty command
+    *
+    * @param index type code less HASH_START, of an existing command type
+    * @pre commandTypes[index] is not nullptr
+    * @post the command takes a slot from pools[index] until it is released
+    * @return the new command, not yet initialized
+    */
+   LibraryCommand* newCommand(int index);
 };
 
 #endif
\ No newline at end of file
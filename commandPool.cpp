@@ -0,0 +1,109 @@
+/** @file commandPool.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A CommandPool hands out storage for commands of one type, takes it
+ *     back when a command is released and hands it out again
+ *   - Owned by CommandFactory, one pool per command type, so building and
+ *     ending a command makes no call to the heap once the pool has grown
+ *
+ * Implementation:
+ *   - Storage is kept in blocks of fixed size slots. Each new block holds
+ *     twice the slots of the last one, up to MAX_BLOCK, like Arena
+ *   - Released slots go on a free list threaded through the slots
+ *     themselves and are handed out again first, newest first
+ *   - The pool never runs constructors or destructors. Every slot still in
+ *     use when the pool is destroyed is freed with its block, so nothing
+ *     can leak, but the commands in it must not be used afterwards
+ *   - allocate() and deallocate() take a lock, so commands can be released
+ *     by the threads of a ParallelExecutor while others are being built
+ */
+
+#include "commandPool.h"
+#include <new>
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** CommandPool()
+ * Constructor
+ *
+ * No storage is allocated until the first call to allocate()
+ * @param slotSize bytes in one command of the pool's type
+ * @pre None.
+ * @post pool exists and is empty
+ */
+CommandPool::CommandPool(size_t slotSize)
+{
+   const size_t ALIGN = alignof(max_align_t);
+   if (slotSize < sizeof(FreeSlot)) {
+      slotSize = sizeof(FreeSlot);
+   }
+   this->slotSize = (slotSize + ALIGN - 1) / ALIGN * ALIGN;
+   capacity = 0;
+   used = 0;
+   freeList = nullptr;
+   live = 0;
+   slots = 0;
+}
+
+// -------------------------------------------------------------------------
+/** ~CommandPool()
+ * Destructor
+ *
+ * Frees every block, including slots still in use
+ * @pre every command built in the pool was released, or is not used again
+ * @post all storage is returned to the system
+ */
+CommandPool::~CommandPool()
+{
+   for (char* block : blocks) {
+      ::operator delete(block);
+   }
+}
+
+// -------------------------------------------------------------------------
+/** allocate()
+ * Get storage for one command
+ *
+ * @pre None.
+ * @post the slot is in use until deallocate() is called with it
+ * @return uninitialized storage of slotSize bytes
+ */
+void* CommandPool::allocate()
+{
+   lock_guard<mutex> guard(lock);
+   live++;
+   if (freeList != nullptr) {
+      FreeSlot* slot = freeList;
+      freeList = slot->next;
+      return slot;
+   }
+   if (used == capacity) {
+      capacity = capacity == 0 ? MIN_BLOCK : capacity * 2;
+      if (capacity > MAX_BLOCK) {
+         capacity = MAX_BLOCK;
+      }
+      blocks.push_back(static_cast<char*>(::operator new(slotSize * capacity)));
+      used = 0;
+      slots += capacity;
+   }
+   return blocks.back() + slotSize * used++;
+}
+
+// -------------------------------------------------------------------------
+/** deallocate()
+ * Give storage back
+ *
+ * @param slot storage returned by allocate() of this pool
+ * @pre the command in slot was destroyed
+ * @post slot is handed out again by a later allocate()
+ */
+void CommandPool::deallocate(void* slot)
+{
+   lock_guard<mutex> guard(lock);
+   live--;
+   FreeSlot* freed = new (slot) FreeSlot;
+   freed->next = freeList;
+   freeList = freed;
+}
@@ -0,0 +1,120 @@
+/** @file commandPool.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A CommandPool hands out storage for commands of one type, takes it
+ *     back when a command is released and hands it out again
+ *   - Owned by CommandFactory, one pool per command type, so building and
+ *     ending a command makes no call to the heap once the pool has grown
+ *
+ * Implementation:
+ *   - Storage is kept in blocks of fixed size slots. Each new block holds
+ *     twice the slots of the last one, up to MAX_BLOCK, like Arena
+ *   - Released slots go on a free list threaded through the slots
+ *     themselves and are handed out again first, newest first
+ *   - The pool never runs constructors or destructors. Every slot still in
+ *     use when the pool is destroyed is freed with its block, so nothing
+ *     can leak, but the commands in it must not be used afterwards
+ *   - allocate() and deallocate() take a lock, so commands can be released
+ *     by the threads of a ParallelExecutor while others are being built
+ */
+
+#ifndef COMMANDPOOL_H
+#define COMMANDPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+class CommandPool
+{
+public:
+   // -------------------------------------------------------------------------
+   /** CommandPool()
+    * Constructor
+    *
+    * No storage is allocated until the first call to allocate()
+    * @param slotSize bytes in one command of the pool's type
+    * @pre None.
+    * @post pool exists and is empty
+    */
+   explicit CommandPool(size_t slotSize);
+
+   // -------------------------------------------------------------------------
+   /** ~CommandPool()
+    * Destructor
+    *
+    * Frees every block, including slots still in use
+    * @pre every command built in the pool was released, or is not used again
+    * @post all storage is returned to the system
+    */
+   ~CommandPool();
+
+   // no copies, the pool owns its blocks
+   CommandPool(const CommandPool&) = delete;
+   CommandPool& operator=(const CommandPool&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** allocate()
+    * Get storage for one command
+    *
+    * @pre None.
+    * @post the slot is in use until deallocate() is called with it
+    * @return uninitialized storage of slotSize bytes
+    */
+   void* allocate();
+
+   // -------------------------------------------------------------------------
+   /** deallocate()
+    * Give storage back
+    *
+    * @param slot storage returned by allocate() of this pool
+    * @pre the command in slot was destroyed
+    * @post slot is handed out again by a later allocate()
+    */
+   void deallocate(void* slot);
+
+   // -------------------------------------------------------------------------
+   /** getLiveCount() / getSlotCount()
+    * Slots in use and slots held
+    *
+    * getLiveCount() is the number of slots handed out and not given back,
+    * getSlotCount() the number of slots in all blocks
+    */
+   int getLiveCount() const { return live; }
+   int getSlotCount() const { return slots; }
+
+private:
+   // smallest and largest number of slots in one block
+   static const int MIN_BLOCK = 64;
+   static const int MAX_BLOCK = 4096;
+
+   // a slot on the free list
+   struct FreeSlot {
+      FreeSlot* next;
+   };
+
+   // bytes in one slot, a multiple of the strictest alignment
+   size_t slotSize;
+
+   // every block, the last one is the one being filled
+   vector<char*> blocks;
+
+   // slots in the last block, and slots handed out from it
+   int capacity;
+   int used;
+
+   // released slots, newest first
+   FreeSlot* freeList;
+
+   // slots handed out and not given back, and slots in all blocks
+   int live;
+   int slots;
+
+   // guards everything above
+   mutex lock;
+};
+
+#endif
@@ -22,6 +22,9 @@
 
 #define COMMAND_BUFFER 10
 
+#define PATRON_ID_LENGTH 4
+#define PATRON_TABLE_SIZE 10000
+
 #define COUNT_BUFFER 6
 #define TITLE_BUFFER 38
 #define AUTHOR_BUFFER 24
@@ -13,7 +13,10 @@
 
 #include "bookDatabase.h"
 #include "constants.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include <string>
+#include <new>
 
 using namespace std;
 
@@ -43,38 +46,49 @@ DisplayLibrary::DisplayLibrary(BookDatabase* books, PatronDatabase* patrons)
  */
 bool DisplayLibrary::execute()
 {
-   bookDB->displayAll();
-   cout << endl;
-   delete this;
+   Metrics::Timer timer(METRIC_DISPLAY_LIBRARY);
+   ostream& os = output();
+   bookDB->displayAll(os);
+   os << '\n';
+   release();
    return true;
 }
 
+// -------------------------------------------------------------------------
+/** isBarrier()
+ * Barrier command
+ *
+ * Displaying the library reads every book
+ * @pre None
+ * @post None. const
+ * @return true
+ */
+bool DisplayLibrary::isBarrier() const { return true; }
+
 /** create()
  * Create Library Command (factory)
  *
- * Create a library command of the appropriate type
- * this function is pure virtual
- * @pre None
- * @post a new library command exists
+ * Create a library command of the appropriate type in slot
+ * @param slot storage for the command, from the factory's CommandPool
+ * @pre slot is big enough for a DisplayLibrary
+ * @post a new library command exists in slot
  */
-LibraryCommand* DisplayLibrary::create() const
+LibraryCommand* DisplayLibrary::create(void* slot) const
 {
-   return new DisplayLibrary(bookDB, patronDB);
+   return new (slot) DisplayLibrary(bookDB, patronDB);
 }
 
 /** initialize()
  * initialize command with data
  *
  * Uses a string to put data into the command
- * @param is incoming stream containing the line of data for display
+ * @param in the rest of the line after the command type
  * @pre string must be formatted properly
  * @post the command now contains the data from the string
  * @return string is not formmatedd correctly return false,
  * else return true
  */
-bool DisplayLibrary::initialize(istream& is)
+bool DisplayLibrary::initialize(FieldReader& /*in*/)
 {
-   string line;
-   getline(is, line);
    return true;
 }
\ No newline at end of file
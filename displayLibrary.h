@@ -40,27 +40,38 @@ public:
     */
    virtual bool execute();
 
+   // -------------------------------------------------------------------------
+   /** isBarrier()
+    * Barrier command
+    *
+    * Displaying the library reads every book
+    * @pre None
+    * @post None. const
+    * @return true
+    */
+   virtual bool isBarrier() const;
+
    /** create()
     * Create Library Command (factory)
     *
-    * Create a library command of the appropriate type
-    * this function is pure virtual
-    * @pre None
-    * @post a new library command exists
+    * Create a library command of the appropriate type in slot
+    * @param slot storage for the command, from the factory's CommandPool
+    * @pre slot is big enough for a DisplayLibrary
+    * @post a new library command exists in slot
     */
-   virtual LibraryCommand* create() const;
+   virtual LibraryCommand* create(void* slot) const;
 
    /** initialize()
     * initialize command with data
     *
     * Uses a string to put data into the command
-    * @param is incoming stream containing the line of data for display
+    * @param in the rest of the line after the command type
     * @pre string must be formatted properly
     * @post the command now contains the data from the string
     * @return string is not formmatedd correctly return false,
     * else return true
     */
-   virtual bool initialize(istream& is);
+   virtual bool initialize(FieldReader& in);
 };
 
 #endif
\ No newline at end of file
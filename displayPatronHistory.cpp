@@ -12,9 +12,13 @@
 #include "displayPatronHistory.h"
 #include "bookDatabase.h"
 #include "constants.h"
+#include "fieldReader.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include "patron.h"
 #include <iostream>
 #include <string>
+#include <new>
 
 using namespace std;
 
@@ -46,44 +50,45 @@ DisplayPatronHistory::DisplayPatronHistory(BookDatabase* books,
  */
 bool DisplayPatronHistory::execute()
 {
-
-   patron->display(cout);
-   cout << endl;
-   delete this;
+   Metrics::Timer timer(METRIC_DISPLAY_PATRON);
+   patron->display(output());
+   output() << '\n';
+   release();
    return true;
 }
 
 /** create()
  * Create Library Command (factory)
  *
- * Create a library command of the appropriate type
- * this function is pure virtual
- * @pre None
- * @post a new library command exists
+ * Create a library command of the appropriate type in slot
+ * @param slot storage for the command, from the factory's CommandPool
+ * @pre slot is big enough for a DisplayPatronHistory
+ * @post a new library command exists in slot
  */
-LibraryCommand* DisplayPatronHistory::create() const
+LibraryCommand* DisplayPatronHistory::create(void* slot) const
 {
-   return new DisplayPatronHistory(bookDB, patronDB);
+   return new (slot) DisplayPatronHistory(bookDB, patronDB);
 }
 
 /** initialize()
  * initialize command with data
  *
  * Uses a string to put data into the command
+ * @param in the rest of the line after the command type
  * @pre string must be formatted properly
  * @post the command now contains the data from the string
  * @return string is not formmatedd correctly return false,
  * else return true
  */
-bool DisplayPatronHistory::initialize(istream& is)
+bool DisplayPatronHistory::initialize(FieldReader& in)
 { // put errors here
-   string patronID, line;
-   is >> patronID;
+   string_view patronID;
+   in.readWord(patronID);
    patron = patronDB->getPatron(patronID);
-   getline(is, line);
    if (patron == nullptr) {
-      cout << "PATRON HISTORY COMMAND INPUT ERROR: PATRON " << patronID
-           << " does not exist." << endl;
+      Metrics::countError(ERROR_UNKNOWN_PATRON);
+      errorOutput() << "PATRON HISTORY COMMAND INPUT ERROR: PATRON " << patronID
+                    << " does not exist.\n";
       return false;
    }
 
@@ -12,12 +12,12 @@
 #include "fiction.h"
 #include "BSTData.h"
 #include "book.h"
+#include "bookKey.h"
 #include "constants.h"
+#include "fieldReader.h"
+#include "outputSink.h"
 #include <iomanip>
 #include <iostream>
-#include <sstream>
-
-#include <regex>
 
 class Patron;
 
@@ -51,27 +51,6 @@ Fiction::Fiction()
  */
 Book* Fiction::create() const { return new Fiction(); }
 
-// -------------------------------------------------------------------------
-/** compare()
- * Compare fiction books
- *
- * Compare 2 fiction books. Returns an integer that reflects the comparison
- * @param rhs Book to be compared
- * @pre None
- * @post new Fiction book object exists
- * @return negative int if left book < right.
- * return 0 if equal, return positive int if left > right
- */
-int Fiction::compare(const Fiction& rhs) const
-{
-   int comparison = author.compare(rhs.author);
-   if (comparison == 0) {
-      comparison = title.compare(rhs.title);
-   }
-
-   return comparison;
-}
-
 // -------------------------------------------------------------------------
 /** operator<()
  * Operator less than overload
@@ -176,7 +155,9 @@ bool Fiction::operator>=(const BSTData& rhs) const
 /** operator=()
  * Copy assignment operator
  *
- * Copy data from right hand item to left hand item.
+ * Copy data from right hand item to left hand item. The author and title
+ * are copied into storage this book owns, so it does not depend on rhs or
+ * its factory's pool.
  * @param rhs Book to be compared
  * @pre Items should not be the same item
  * @post left item contains data from rhs, right item is const
@@ -186,54 +167,55 @@ BSTData& Fiction::operator=(const BSTData& rhs)
 {
    const Fiction& right = static_cast<const Fiction&>(rhs);
    if (this != &right) {
-      author = right.author;
-      title = right.title;
+      setNames(right.author, right.title);
       year = right.year;
    }
    return *this;
 }
 
 // -------------------------------------------------------------------------
-/** setData()
- * input data into node
+/** parseKey()
+ * Parse a book key
  *
- * Take data from inputStream and put into node members
- * @param is line of fiction book data
- * @pre must have a properly formatted input file
- * @post line of input is read. BSTData contains line data
- * @return true if line of data was read, false if no line or bad format
+ * Parses the rest of a book line with the book's checks and error
+ * messages. Book::setData and BookFactory::createKey both use it
+ * @param in the rest of the line after the type code
+ * @param key set to the book's identifying fields
+ * @pre None
+ * @post the line is read. key holds its data if it was valid
+ * @return true if the line was valid, false if bad format
  */
-bool Fiction::setData(istream& is)
+bool Fiction::parseKey(FieldReader& in, BookKey& key) const
 {
-   string line;
+   string_view line;
+   key.typeCode = typeCode;
+   key.type = type;
 
-   is.get();
-   char form = is.get();
-   if (is.peek() == ' ') {
+   in.get();
+   char form = in.get();
+   if (in.peek() == ' ') {
       if (form != format) {
-         cout << type << "BOOK INPUT ERROR: " << form
-              << " is not a recognized format." << endl;
-         getline(is, line);
+         errorOutput() << type << "BOOK INPUT ERROR: " << form
+                       << " is not a recognized format.\n";
          return false;
       }
-      is.get();
+      in.get();
    } else {
-      is.unget();
+      in.unget();
    }
-   stringstream data;
-   getline(is, line);
-   data.str(line);
+   in.rest(line);
+   FieldReader data(line);
 
-   getline(data, author, ',');
+   data.getline(key.author, ',');
    data.get();
-   getline(data, title, ',');
+   data.getline(key.title, ',');
 
-   data >> year;
+   data.readInt(key.year);
 
-   if (year < 0) {
-      cout << TYPE_FICTION << " BOOK INPUT ERROR: For book titled " << endl
-           << title.substr(0, TITLE_MAX_LENGTH) << ","
-           << " year " << year << " is not a valid year." << endl;
+   if (key.year < 0) {
+      errorOutput() << TYPE_FICTION << " BOOK INPUT ERROR: For book titled \n"
+                    << key.title.substr(0, TITLE_MAX_LENGTH) << ","
+                    << " year " << key.year << " is not a valid year.\n";
       return false;
    }
 
@@ -296,7 +278,7 @@ ostream& Fiction::displayHeader(ostream& os) const
 {
    os.setf(ios::left, ios::adjustfield);
 
-   os << type << " BOOKS" << endl;
+   os << type << " BOOKS\n";
    os << setw(COUNT_BUFFER) << "AVAIL" << setw(AUTHOR_BUFFER) << "AUTHOR"
       << setw(TITLE_BUFFER) << "TITLE" << setw(YEAR_BUFFER) << "YEAR";
 
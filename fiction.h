@@ -12,6 +12,7 @@
 #define FICTION_H
 
 #include "book.h"
+#include "bookKey.h"
 #include "constants.h"
 #include <string>
 
@@ -125,7 +126,9 @@ public:
    /** operator=()
     * Copy assignment operator
     *
-    * Copy data from right hand item to left hand item.
+    * Copy data from right hand item to left hand item. The author and title
+    * are copied into storage this book owns, so it does not depend on rhs or
+    * its factory's pool.
     * @param rhs Book who's data will be duplicated
     * @pre Items should not be the same item
     * @post left item contains data from rhs, right item is const
@@ -133,18 +136,6 @@ public:
     */
    virtual BSTData& operator=(const BSTData& rhs);
 
-   // -------------------------------------------------------------------------
-   /** setData()
-    * input data into node
-    *
-    * Take data from inputStream and put into node members
-    * @param is stream line of data for book
-    * @pre must have a properly formatted input file
-    * @post line of input is read. BSTData contains line data
-    * @return true if line of data was read, false if no line or bad format
-    */
-   virtual bool setData(istream& is);
-
    // -------------------------------------------------------------------------
    /** display()
     * Display book information
@@ -183,7 +174,33 @@ public:
     */
    virtual ostream& displayHeader(ostream& os) const;
 
-private:
+   // -------------------------------------------------------------------------
+   /** parseKey()
+    * Parse a book key
+    *
+    * Parses the rest of a book line with the book's checks and error
+    * messages. Book::setData and BookFactory::createKey both use it
+    * @param in the rest of the line after the type code
+    * @param key set to the book's identifying fields
+    * @pre None
+    * @post the line is read. key holds its data if it was valid
+    * @return true if the line was valid, false if bad format
+    */
+   virtual bool parseKey(FieldReader& in, BookKey& key) const;
+
+   // -------------------------------------------------------------------------
+   /** compareKey()
+    * Compare a key with this book
+    *
+    * Same ordering as compare(), with the key on the left
+    * @param key key to be compared, of this book's type
+    * @pre None
+    * @post None. const
+    * @return negative int if key < this book.
+    * return 0 if equal, return positive int if key > this book
+    */
+   int compareKey(const BookKey& key) const;
+
    // -------------------------------------------------------------------------
    /** compare()
     * Compare fiction books
@@ -197,7 +214,34 @@ private:
     */
    int compare(const Fiction& rhs) const;
 
+private:
    // current patrons checking out the book. max size is maxCount
 };
 
+// inline so BookCompare can inline it into shelf lookups. Views of the
+// same text, such as pooled names, are equal without comparing the text.
+// Views of different storage are compared, whatever pool they came from
+inline int Fiction::compare(const Fiction& rhs) const
+{
+   int comparison = 0;
+   if (!sameView(author, rhs.author)) {
+      comparison = author.compare(rhs.author);
+   }
+   if (comparison == 0 && !sameView(title, rhs.title)) {
+      comparison = title.compare(rhs.title);
+   }
+
+   return comparison;
+}
+
+inline int Fiction::compareKey(const BookKey& key) const
+{
+   int comparison = key.author.compare(author);
+   if (comparison == 0) {
+      comparison = key.title.compare(title);
+   }
+
+   return comparison;
+}
+
 #endif
\ No newline at end of file
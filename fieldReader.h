@@ -0,0 +1,278 @@
+/** @file fieldReader.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A FieldReader reads characters, delimited fields and integers out of
+ *     one line of input held in a string_view
+ *   - Fields come back as string_views into the line, nothing is copied
+ *     and nothing is allocated
+ *
+ * Implementation:
+ *   - Each function behaves like the istream function of the same name on a
+ *     stringstream holding the line, including the fail and eof states, so
+ *     parsing code can switch from stringstream to FieldReader without
+ *     changing what it accepts or what ends up in each field
+ *   - Once a read fails every later read fails too, like a failed stream
+ */
+
+#ifndef FIELDREADER_H
+#define FIELDREADER_H
+
+#include <climits>
+#include <string_view>
+
+using namespace std;
+
+class FieldReader
+{
+public:
+   // value get() and peek() return when there is no character, like EOF
+   static const int END = -1;
+
+   // -------------------------------------------------------------------------
+   /** FieldReader()
+    * Constructor
+    *
+    * Creates a reader positioned at the start of line
+    * @param line the text to read, must outlive the reader and its fields
+    * @pre None.
+    * @post reader is good and at the start of line
+    */
+   explicit FieldReader(string_view line)
+   {
+      this->line = line;
+      pos = 0;
+      failed = false;
+      ended = false;
+   }
+
+   // -------------------------------------------------------------------------
+   /** get()
+    * Read one character
+    *
+    * @pre None.
+    * @post the character is consumed. At the end of the line the reader
+    * fails
+    * @return the character as an unsigned char, or END
+    */
+   int get()
+   {
+      if (!good() || pos == line.size()) {
+         failed = true;
+         ended = ended || pos == line.size();
+         return END;
+      }
+      return (unsigned char)line[pos++];
+   }
+
+   // -------------------------------------------------------------------------
+   /** peek()
+    * Look at the next character
+    *
+    * @pre None.
+    * @post nothing is consumed. At the end of the line eof() becomes true
+    * @return the next character as an unsigned char, or END
+    */
+   int peek()
+   {
+      if (!good()) {
+         failed = true;
+         return END;
+      }
+      if (pos == line.size()) {
+         ended = true;
+         return END;
+      }
+      return (unsigned char)line[pos];
+   }
+
+   // -------------------------------------------------------------------------
+   /** unget()
+    * Put back the last character read
+    *
+    * Clears eof first, so a character read right before the end can still
+    * be put back, like istream::unget
+    * @pre None.
+    * @post one character less has been consumed, unless the reader failed
+    */
+   void unget()
+   {
+      ended = false;
+      if (failed || pos == 0) {
+         failed = true;
+         return;
+      }
+      pos--;
+   }
+
+   // -------------------------------------------------------------------------
+   /** getline()
+    * Read a field
+    *
+    * Reads up to delim or the end of the line. delim is consumed but not part
+    * of field. Reaching the end sets eof, and fails if nothing at all was
+    * consumed, like the getline that takes a delimiter.
+    * @param field set to the characters read, unchanged if already failed
+    * @param delim character that ends the field
+    * @pre None.
+    * @post the field and delim are consumed
+    * @return false if the reader has failed
+    */
+   bool getline(string_view& field, char delim)
+   {
+      if (!good()) {
+         failed = true;
+         return false;
+      }
+      size_t end = line.find(delim, pos);
+      if (end == string_view::npos) {
+         field = line.substr(pos);
+         ended = true;
+         failed = pos == line.size();
+         pos = line.size();
+      } else {
+         field = line.substr(pos, end - pos);
+         pos = end + 1;
+      }
+      return !failed;
+   }
+
+   // -------------------------------------------------------------------------
+   /** rest()
+    * Read the rest of the line
+    *
+    * Same as getline with a delimiter that never appears in the line
+    * @param field set to the rest of the line, unchanged if already failed
+    * @pre None.
+    * @post the whole line is consumed
+    * @return false if the reader has failed
+    */
+   bool rest(string_view& field) { return getline(field, '\n'); }
+
+   // -------------------------------------------------------------------------
+   /** readWord()
+    * Read a word
+    *
+    * Skips whitespace and reads up to the next whitespace or the end of the
+    * line, like operator>>(string&). If only whitespace is left the reader
+    * fails and word is unchanged.
+    * @param word set to the characters read
+    * @pre None.
+    * @post the whitespace and the word are consumed
+    * @return false if the reader has failed
+    */
+   bool readWord(string_view& word)
+   {
+      if (!good()) {
+         failed = true;
+         return false;
+      }
+      while (pos < line.size() && isSpace(line[pos])) {
+         pos++;
+      }
+      if (pos == line.size()) {
+         failed = ended = true;
+         return false;
+      }
+      size_t start = pos;
+      while (pos < line.size() && !isSpace(line[pos])) {
+         pos++;
+      }
+      word = line.substr(start, pos - start);
+      ended = pos == line.size();
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   /** readInt()
+    * Read an integer
+    *
+    * Skips whitespace and reads an optionally signed decimal integer, like
+    * operator>>(int&). If there are no digits value becomes 0 and the reader
+    * fails. If the number does not fit value becomes INT_MAX or INT_MIN and
+    * the reader fails. If the reader has already failed, or only whitespace
+    * is left, value is unchanged.
+    * @param value where the integer is stored
+    * @pre None.
+    * @post the whitespace and the integer are consumed
+    * @return false if the reader has failed
+    */
+   bool readInt(int& value)
+   {
+      if (!good()) {
+         failed = true;
+         return false;
+      }
+      while (pos < line.size() && isSpace(line[pos])) {
+         pos++;
+      }
+      if (pos == line.size()) {
+         failed = ended = true;
+         return false;
+      }
+
+      bool negative = false;
+      if (line[pos] == '-' || line[pos] == '+') {
+         negative = line[pos] == '-';
+         pos++;
+      }
+      long long magnitude = 0;
+      bool digits = false;
+      bool overflow = false;
+      while (pos < line.size() && line[pos] >= '0' && line[pos] <= '9') {
+         digits = true;
+         if (magnitude <= (long long)INT_MAX + 1) {
+            magnitude = magnitude * 10 + (line[pos] - '0');
+         }
+         pos++;
+      }
+      ended = pos == line.size();
+
+      if (!digits) {
+         value = 0;
+         failed = true;
+      } else if (!negative && magnitude > INT_MAX) {
+         value = INT_MAX;
+         overflow = true;
+      } else if (negative && magnitude > (long long)INT_MAX + 1) {
+         value = INT_MIN;
+         overflow = true;
+      } else {
+         value = (int)(negative ? -magnitude : magnitude);
+      }
+      failed = failed || overflow;
+      return !failed;
+   }
+
+   // -------------------------------------------------------------------------
+   /** good() / fail() / eof()
+    * Reader state
+    *
+    * good() is true until a read fails or the end of the line is reached
+    */
+   bool good() const { return !failed && !ended; }
+   bool fail() const { return failed; }
+   bool eof() const { return ended; }
+
+private:
+   // the line being read
+   string_view line;
+
+   // index of the next character to read
+   size_t pos;
+
+   // a read failed, every later read fails
+   bool failed;
+
+   // the end of the line was reached
+   bool ended;
+
+   // the characters operator>> skips
+   static bool isSpace(char c)
+   {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+             c == '\r';
+   }
+};
+
+#endif
@@ -12,6 +12,16 @@
  *     and CommandFactory respectively
  *   - Executes commands with a queue to simmulate patrons entering commands
  *     in a set order
+ *   - Can instead stream commands: parse a window of commands, execute
+ *     them, parse the next window. Memory stays bounded by the window, and
+ *     command output is spooled so the output is the same as with the queue
+ *   - Command lines come from a LineSource, so a command file can be read
+ *     straight out of a memory mapping
+ *   - Parsed commands execute in order on one thread, or on several with a
+ *     ParallelExecutor (ExecuteMode). The output is the same either way
+ *   - Can also pipe commands: a parser thread hands each command through a
+ *     RingBuffer to the calling thread, which executes it while the next
+ *     lines are parsed. Command output is spooled as in streamCommands
  *
  */
 
@@ -19,10 +29,18 @@
 #include "bookDatabase.h"
 #include "commandFactory.h"
 #include "libraryCommand.h"
+#include "lineSource.h"
+#include "metrics.h"
+#include "outputSink.h"
+#include "outputSpool.h"
+#include "parallelExecutor.h"
 #include "patronDatabase.h"
+#include "ringBuffer.h"
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <queue>
-#include <sstream>
+#include <thread>
 
 using namespace std;
 
@@ -38,6 +56,11 @@ Library::Library()
    bookDB = nullptr;
    patronDB = nullptr;
    commandFactory = nullptr;
+   commandsParsed = 0;
+   peakResident = 0;
+   parseSeconds = 0;
+   executeSeconds = 0;
+   executor = nullptr;
 }
 
 // -------------------------------------------------------------------------
@@ -53,6 +76,7 @@ Library::~Library()
    delete patronDB;
 
    delete commandFactory;
+   delete executor;
 }
 
 // -------------------------------------------------------------------------
@@ -66,26 +90,328 @@ Library::~Library()
  */
 void Library::processCommands(istream& is)
 {
-   queue<LibraryCommand*> commandQueue;
+   LineSource lines(is);
+   processCommands(lines);
+}
 
-   while (!is.eof()) {
+// -------------------------------------------------------------------------
+/** processComands()
+ * Same as processCommands(istream&), reading the commands from a
+ * LineSource, such as a memory-mapped command file
+ * @param lines source of command lines
+ * @pre None.
+ * @post commands are executed based on the parameter
+ */
+void Library::processCommands(LineSource& lines)
+{
+   queue<LibraryCommand*> commandQueue;
+   commandsParsed = 0;
+   pipeStats = PipeStats();
+   auto start = chrono::steady_clock::now();
 
-      string line;
-      stringstream inputLine;
-      getline(is, line);
-      if (line.empty()) {
-         continue;
-      }
-      inputLine.str(line);
-      LibraryCommand* comm = commandFactory->createCommand(inputLine);
+   string_view line;
+   while (lines.next(line)) {
+      LibraryCommand* comm = parseCommand(line);
       if (comm != nullptr) {
          commandQueue.push(comm);
-      } else {
-         cout << endl;
       }
    }
+   peakResident = (int)commandQueue.size();
+   auto parsed = chrono::steady_clock::now();
 
    executeCommands(commandQueue);
+   parseSeconds = chrono::duration<double>(parsed - start).count();
+   executeSeconds =
+       chrono::duration<double>(chrono::steady_clock::now() - parsed).count();
+}
+
+// -------------------------------------------------------------------------
+/** streamCommands()
+ * Process commands in bounded memory
+ *
+ * Parses up to window commands, executes them, then parses the next
+ * window, so at most window commands are waiting at any time. Parse
+ * errors are printed as they are found. Command output is spooled and
+ * printed after the last parse error, so the output is byte-identical to
+ * processCommands.
+ * @param is stream of commands, one per line
+ * @param window most commands parsed ahead of execution, at least 1
+ * @pre None.
+ * @post commands are executed based on the parameter
+ */
+void Library::streamCommands(istream& is, int window)
+{
+   LineSource lines(is);
+   streamCommands(lines, window);
+}
+
+// -------------------------------------------------------------------------
+/** streamCommands()
+ * Same as streamCommands(istream&, int), reading the commands from a
+ * LineSource, such as a memory-mapped command file
+ * @param lines source of command lines
+ * @param window most commands parsed ahead of execution, at least 1
+ * @pre None.
+ * @post commands are executed based on the parameter
+ */
+void Library::streamCommands(LineSource& lines, int window)
+{
+   if (window < 1) {
+      window = 1;
+   }
+   OutputSpool spoolBuffer;
+   ostream spool(&spoolBuffer);
+   vector<LibraryCommand*> pending;
+   pending.reserve(window);
+   commandsParsed = 0;
+   peakResident = 0;
+   pipeStats = PipeStats();
+   // parsing never changes the flags of output(), so they are what executing
+   // the queue would have started with
+   spool.flags(output().flags());
+   auto start = chrono::steady_clock::now();
+   chrono::steady_clock::duration executing(0);
+
+   string_view line;
+   while (lines.next(line)) {
+      LibraryCommand* comm = parseCommand(line);
+      if (comm == nullptr) {
+         continue;
+      }
+      pending.push_back(comm);
+      if ((int)pending.size() > peakResident) {
+         peakResident = (int)pending.size();
+      }
+      if ((int)pending.size() == window) {
+         auto windowStart = chrono::steady_clock::now();
+         executeWindow(pending, spool);
+         executing += chrono::steady_clock::now() - windowStart;
+      }
+   }
+   auto windowStart = chrono::steady_clock::now();
+   executeWindow(pending, spool);
+   auto end = chrono::steady_clock::now();
+   executing += end - windowStart;
+   executeSeconds = chrono::duration<double>(executing).count();
+   parseSeconds =
+       chrono::duration<double>(end - start).count() - executeSeconds;
+
+   spoolBuffer.copyTo(output());
+   output().flags(spool.flags());
+}
+
+// -------------------------------------------------------------------------
+/** pipeCommands()
+ * Parse and execute at the same time
+ *
+ * A second thread parses the lines and passes each command through a
+ * ring of capacity slots to this thread, which executes them in order
+ * while parsing goes on. Parse errors are printed as they are found.
+ * Command output is spooled and printed after the last parse error, so
+ * the output is byte-identical to processCommands. Throughput and ring
+ * occupancy are shown by displayStats afterwards.
+ * @param is stream of commands, one per line
+ * @param capacity most commands parsed ahead of execution, at least 1
+ * @pre None.
+ * @post commands are executed based on the parameter
+ */
+void Library::pipeCommands(istream& is, int capacity)
+{
+   LineSource lines(is);
+   pipeCommands(lines, capacity);
+}
+
+// -------------------------------------------------------------------------
+/** pipeCommands()
+ * Same as pipeCommands(istream&, int), reading the commands from a
+ * LineSource, such as a memory-mapped command file
+ * @param lines source of command lines
+ * @param capacity most commands parsed ahead of execution, at least 1
+ * @pre None.
+ * @post commands are executed based on the parameter
+ */
+void Library::pipeCommands(LineSource& lines, int capacity)
+{
+   if (capacity < 1) {
+      capacity = 1;
+   }
+   RingBuffer<LibraryCommand*> ring(capacity);
+   OutputSpool spoolBuffer;
+   ostream spool(&spoolBuffer);
+   ostream& out = output();
+   commandsParsed = 0;
+   peakResident = 0;
+   pipeStats = PipeStats();
+   pipeStats.piped = true;
+   pipeStats.capacity = (int)ring.getCapacity();
+   // parsing never changes the flags of output(), so they are what executing
+   // the queue would have started with
+   spool.flags(out.flags());
+   auto start = chrono::steady_clock::now();
+
+   // parse errors go straight to this thread's output()
+   thread parser([&] {
+      OutputScope toOut(out);
+      string_view line;
+      while (lines.next(line)) {
+         LibraryCommand* comm = parseCommand(line);
+         if (comm == nullptr) {
+            continue;
+         }
+         while (!ring.tryPush(comm)) {
+            pipeStats.parserWaits++;
+            ring.waitForRoom();
+         }
+      }
+      ring.close();
+      pipeStats.parseSeconds =
+          chrono::duration<double>(chrono::steady_clock::now() - start)
+              .count();
+   });
+
+   // commands waiting for the parallel executor, run whenever the ring
+   // runs dry or the batch is as big as the ring
+   vector<LibraryCommand*> batch;
+   {
+      OutputScope toSpool(spool);
+      LibraryCommand* comm;
+      while (true) {
+         int waiting = (int)ring.getSize();
+         if (ring.tryPop(comm)) {
+            pipeStats.executed++;
+            pipeStats.occupancySum += waiting;
+            if (waiting + (int)batch.size() > peakResident) {
+               peakResident = waiting + (int)batch.size();
+            }
+            if (executor == nullptr) {
+               if (!comm->execute()) {
+                  errorOutput() << '\n';
+               }
+            } else {
+               batch.push_back(comm);
+               if ((int)batch.size() == capacity) {
+                  executor->execute(batch);
+               }
+            }
+            continue;
+         }
+         if (!batch.empty()) {
+            executor->execute(batch);
+            continue;
+         }
+         // closed, and nothing pushed before close() is left
+         if (ring.isClosed() && ring.getSize() == 0) {
+            break;
+         }
+         pipeStats.executorWaits++;
+         ring.waitForItem();
+      }
+   }
+   parser.join();
+   pipeStats.totalSeconds =
+       chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   parseSeconds = pipeStats.parseSeconds;
+   executeSeconds = pipeStats.totalSeconds;
+
+   spoolBuffer.copyTo(out);
+   out.flags(spool.flags());
+}
+
+// -------------------------------------------------------------------------
+/** parseCommand()
+ * Parse one line
+ *
+ * Creates the command for one line. A line that fails prints its error
+ * followed by an empty line.
+ * @param line one line of command input
+ * @pre None.
+ * @post commandsParsed counts the line if it was not empty
+ * @return the new command, nullptr if the line was empty or bad
+ */
+LibraryCommand* Library::parseCommand(string_view line)
+{
+   if (line.empty()) {
+      return nullptr;
+   }
+   commandsParsed++;
+
+   Metrics::Timer timer(METRIC_PARSE);
+   LibraryCommand* comm = commandFactory->createCommand(line);
+   if (comm == nullptr) {
+      errorOutput() << '\n';
+   }
+   return comm;
+}
+
+// -------------------------------------------------------------------------
+/** setExecuteMode()
+ * Choose how commands execute
+ *
+ * @param mode EXECUTE_SERIAL or EXECUTE_PARALLEL
+ * @param threads threads EXECUTE_PARALLEL runs commands on, 0 for one
+ * per core
+ * @pre None.
+ * @post later processCommands and streamCommands execute as mode says
+ */
+void Library::setExecuteMode(ExecuteMode mode, int threads)
+{
+   delete executor;
+   executor = nullptr;
+   if (mode == EXECUTE_PARALLEL) {
+      executor = new ParallelExecutor(threads);
+   }
+}
+
+// -------------------------------------------------------------------------
+/** getPeakResident()
+ * Peak resident commands
+ *
+ * The most commands that were parsed and waiting to execute at one time,
+ * during the last processCommands or streamCommands
+ * @pre None.
+ * @post None. const function
+ * @return peak number of commands waiting to execute
+ */
+int Library::getPeakResident() const { return peakResident; }
+
+// -------------------------------------------------------------------------
+/** displayStats()
+ * Displays the size and tree height of every book shelf and of the patron
+ * database, plus the average comparisons per lookup so far. Useful right
+ * after LibraryBuilder::createLibrary to check the shape of the trees.
+ * Also the number of commands parsed, the peak resident commands and
+ * the time spent parsing and executing them, and after pipeCommands the
+ * throughput and ring occupancy.
+ * @param os stream the statistics are written to
+ * @pre Library was built by a LibraryBuilder
+ * @post None. const function
+ */
+void Library::displayStats(ostream& os) const
+{
+   bookDB->displayStats(os);
+   patronDB->displayStats(os);
+   os << "COMMANDS: " << commandsParsed << " parsed, peak " << peakResident
+      << " resident\n";
+   ios::fmtflags oldFlags = os.flags();
+   streamsize oldPrecision = os.precision();
+   os << fixed << setprecision(1);
+   os << "COMMANDS: " << parseSeconds * 1000 << " ms parsing, "
+      << executeSeconds * 1000 << " ms executing\n";
+   if (pipeStats.piped) {
+      const PipeStats& pipe = pipeStats;
+      os << "PIPELINE: " << pipe.executed << " commands in "
+         << pipe.totalSeconds * 1000 << " ms ("
+         << (pipe.totalSeconds > 0 ? pipe.executed / pipe.totalSeconds : 0)
+         << " per second), parsing done at " << pipe.parseSeconds * 1000
+         << " ms\n";
+      os << "PIPELINE: ring of " << pipe.capacity << ", average "
+         << (pipe.executed > 0 ? (double)pipe.occupancySum / pipe.executed
+                               : 0.0)
+         << " waiting, parser waited " << pipe.parserWaits
+         << " times, executor waited " << pipe.executorWaits << " times\n";
+   }
+   os.flags(oldFlags);
+   os.precision(oldPrecision);
 }
 
 // -------------------------------------------------------------------------
@@ -94,18 +420,56 @@ void Library::processCommands(istream& is)
  *
  * Takes a command out of the front of the queue and invokes its execute
  * method, thereby simmulating the natural order of patron command
- * execution.
+ * execution. In EXECUTE_PARALLEL the executor runs the whole queue.
  * @param commands queue of commands to be iteratively executed
  * @pre None.
  * @post Commandqueue is empty
  */
 void Library::executeCommands(queue<LibraryCommand*>& commands)
 {
+   if (executor != nullptr) {
+      vector<LibraryCommand*> all;
+      all.reserve(commands.size());
+      while (!commands.empty()) {
+         all.push_back(commands.front());
+         commands.pop();
+      }
+      executor->execute(all);
+      return;
+   }
    while (!commands.empty()) {
       LibraryCommand* comm = commands.front();
       commands.pop();
       if (!comm->execute()) {
-         cout << endl;
+         errorOutput() << '\n';
+      }
+   }
+}
+
+// -------------------------------------------------------------------------
+/** executeWindow()
+ * Execute a window of commands
+ *
+ * Executes the commands in order with output() sent to spool, printing
+ * an empty line after each one that fails, like executeCommands. spool
+ * keeps the flags the commands left it with from one window to the next.
+ * @param commands commands to execute, in order
+ * @param spool stream over the spool command output goes to
+ * @pre None.
+ * @post commands is empty. Their output is in spool
+ */
+void Library::executeWindow(vector<LibraryCommand*>& commands,
+                            ostream& spool)
+{
+   OutputScope toSpool(spool);
+   if (executor != nullptr) {
+      executor->execute(commands);
+      return;
+   }
+   for (LibraryCommand* comm : commands) {
+      if (!comm->execute()) {
+         errorOutput() << '\n';
       }
    }
+   commands.clear();
 }
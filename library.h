@@ -12,6 +12,16 @@
  *     and CommandFactory respectively
  *   - Executes commands with a queue to simmulate patrons entering commands
  *     in a set order
+ *   - Can instead stream commands: parse a window of commands, execute
+ *     them, parse the next window. Memory stays bounded by the window, and
+ *     command output is spooled so the output is the same as with the queue
+ *   - Command lines come from a LineSource, so a command file can be read
+ *     straight out of a memory mapping
+ *   - Parsed commands execute in order on one thread, or on several with a
+ *     ParallelExecutor (ExecuteMode). The output is the same either way
+ *   - Can also pipe commands: a parser thread hands each command through a
+ *     RingBuffer to the calling thread, which executes it while the next
+ *     lines are parsed. Command output is spooled as in streamCommands
  *
  */
 
@@ -21,19 +31,34 @@
 #include <iostream>
 
 #include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
 
 class CommandQueue;
 class CommandFactory;
 class BookDatabase;
 class PatronDatabase;
 class LibraryCommand;
+class LineSource;
+class ParallelExecutor;
 
 using namespace std;
 
+// How Library executes the commands it has parsed
+enum ExecuteMode {
+   // one after another on the calling thread
+   EXECUTE_SERIAL,
+   // on several threads, commands that share a patron or a book in order
+   // and display library alone. Same results and output as EXECUTE_SERIAL
+   EXECUTE_PARALLEL
+};
+
 class Library
 {
 
    friend class LibraryBuilder;
+   friend class LibrarySnapshot;
 
 public:
    // -------------------------------------------------------------------------
@@ -65,6 +90,112 @@ public:
     */
    void processCommands(istream& is);
 
+   // -------------------------------------------------------------------------
+   /** processComands()
+    * Same as processCommands(istream&), reading the commands from a
+    * LineSource, such as a memory-mapped command file
+    * @param lines source of command lines
+    * @pre None.
+    * @post commands are executed based on the parameter
+    */
+   void processCommands(LineSource& lines);
+
+   // -------------------------------------------------------------------------
+   /** streamCommands()
+    * Process commands in bounded memory
+    *
+    * Parses up to window commands, executes them, then parses the next
+    * window, so at most window commands are waiting at any time. Parse
+    * errors are printed as they are found. Command output is spooled and
+    * printed after the last parse error, so the output is byte-identical to
+    * processCommands.
+    * @param is stream of commands, one per line
+    * @param window most commands parsed ahead of execution, at least 1
+    * @pre None.
+    * @post commands are executed based on the parameter
+    */
+   void streamCommands(istream& is, int window = DEFAULT_WINDOW);
+
+   // -------------------------------------------------------------------------
+   /** streamCommands()
+    * Same as streamCommands(istream&, int), reading the commands from a
+    * LineSource, such as a memory-mapped command file
+    * @param lines source of command lines
+    * @param window most commands parsed ahead of execution, at least 1
+    * @pre None.
+    * @post commands are executed based on the parameter
+    */
+   void streamCommands(LineSource& lines, int window = DEFAULT_WINDOW);
+
+   // -------------------------------------------------------------------------
+   /** pipeCommands()
+    * Parse and execute at the same time
+    *
+    * A second thread parses the lines and passes each command through a
+    * ring of capacity slots to this thread, which executes them in order
+    * while parsing goes on. Parse errors are printed as they are found.
+    * Command output is spooled and printed after the last parse error, so
+    * the output is byte-identical to processCommands. Throughput and ring
+    * occupancy are shown by displayStats afterwards.
+    * @param is stream of commands, one per line
+    * @param capacity most commands parsed ahead of execution, at least 1
+    * @pre None.
+    * @post commands are executed based on the parameter
+    */
+   void pipeCommands(istream& is, int capacity = DEFAULT_WINDOW);
+
+   // -------------------------------------------------------------------------
+   /** pipeCommands()
+    * Same as pipeCommands(istream&, int), reading the commands from a
+    * LineSource, such as a memory-mapped command file
+    * @param lines source of command lines
+    * @param capacity most commands parsed ahead of execution, at least 1
+    * @pre None.
+    * @post commands are executed based on the parameter
+    */
+   void pipeCommands(LineSource& lines, int capacity = DEFAULT_WINDOW);
+
+   // -------------------------------------------------------------------------
+   /** setExecuteMode()
+    * Choose how commands execute
+    *
+    * @param mode EXECUTE_SERIAL or EXECUTE_PARALLEL
+    * @param threads threads EXECUTE_PARALLEL runs commands on, 0 for one
+    * per core
+    * @pre None.
+    * @post later processCommands and streamCommands execute as mode says
+    */
+   void setExecuteMode(ExecuteMode mode, int threads = 0);
+
+   // -------------------------------------------------------------------------
+   /** displayStats()
+    * Displays the size and tree height of every book shelf and of the patron
+    * database, plus the average comparisons per lookup so far. Useful right
+    * after LibraryBuilder::createLibrary to check the shape of the trees.
+    * Also the number of commands parsed, the peak resident commands and
+    * the time spent parsing and executing them, and after pipeCommands the
+    * throughput and ring occupancy.
+    * @param os stream the statistics are written to
+    * @pre Library was built by a LibraryBuilder
+    * @post None. const function
+    */
+   void displayStats(ostream& os) const;
+
+   // -------------------------------------------------------------------------
+   /** getPeakResident()
+    * Peak resident commands
+    *
+    * The most commands that were parsed and waiting to execute at one time,
+    * during the last processCommands or streamCommands
+    * @pre None.
+    * @post None. const function
+    * @return peak number of commands waiting to execute
+    */
+   int getPeakResident() const;
+
+   // commands streamCommands parses ahead by default
+   static const int DEFAULT_WINDOW = 1024;
+
 private:
    // this member class is the d-base that holds all of the books for library
    BookDatabase* bookDB;
@@ -74,18 +205,84 @@ private:
    // Factory for creating commands and queue for execution order
    CommandFactory* commandFactory;
 
+   // commands read by the last processCommands or streamCommands
+   long long commandsParsed;
+
+   // most commands waiting to execute at one time
+   int peakResident;
+
+   // seconds the last run spent parsing commands and executing them. After
+   // pipeCommands they overlap: parsing is the time to the last line parsed
+   // and executing the whole run
+   double parseSeconds;
+   double executeSeconds;
+
+   // runs the commands in EXECUTE_PARALLEL, nullptr in EXECUTE_SERIAL
+   ParallelExecutor* executor;
+
+   // what the last pipeCommands measured
+   struct PipeStats {
+      // true if the last run was pipeCommands
+      bool piped = false;
+
+      // slots in the ring
+      int capacity = 0;
+
+      // seconds from the start to the last line parsed, and to the end
+      double parseSeconds = 0;
+      double totalSeconds = 0;
+
+      // commands taken from the ring, and the sum of the commands waiting
+      // in it each time one was taken
+      long long executed = 0;
+      long long occupancySum = 0;
+
+      // times the parser found the ring full and the executor found it
+      // empty, and had to wait
+      long long parserWaits = 0;
+      long long executorWaits = 0;
+   };
+   PipeStats pipeStats;
+
+   // -------------------------------------------------------------------------
+   /** parseCommand()
+    * Parse one line
+    *
+    * Creates the command for one line. A line that fails prints its error
+    * followed by an empty line.
+    * @param line one line of command input
+    * @pre None.
+    * @post commandsParsed counts the line if it was not empty
+    * @return the new command, nullptr if the line was empty or bad
+    */
+   LibraryCommand* parseCommand(string_view line);
+
    // -------------------------------------------------------------------------
    /** executeCommands()
     * Execute Command Queue
     *
     * Takes a command out of the front of the queue and invokes its execute
     * method, thereby simmulating the natural order of patron command
-    * execution.
+    * execution. In EXECUTE_PARALLEL the executor runs the whole queue.
     * @param commands queue of commands to be iteratively executed
     * @pre None.
     * @post Commandqueue is empty
     */
    void executeCommands(queue<LibraryCommand*>& commands);
+
+   // -------------------------------------------------------------------------
+   /** executeWindow()
+    * Execute a window of commands
+    *
+    * Executes the commands in order with output() sent to spool, printing
+    * an empty line after each one that fails, like executeCommands. spool
+    * keeps the flags the commands left it with from one window to the next.
+    * @param commands commands to execute, in order
+    * @param spool stream over the spool command output goes to
+    * @pre None.
+    * @post commands is empty. Their output is in spool
+    */
+   void executeWindow(vector<LibraryCommand*>& commands, ostream& spool);
 };
 
 #endif
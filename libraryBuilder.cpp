@@ -8,6 +8,16 @@
  * Implementation:
  *   - Library contents are streamed into a file
  *   - Library items operate with their own indipendent input files
+ *   - Records are either inserted one at a time as they are read, or staged
+ *     and bulk loaded once the whole file has been read (LoadMode)
+ *   - Records come from LineSources, so books are parsed straight out of
+ *     a memory-mapped file
+ *   - LOAD_PARALLEL parses books on several threads and builds every shelf
+ *     and the patron database at the same time. Error messages are kept
+ *     with their line and printed in input order, so the output is the
+ *     same as LOAD_SERIAL
+ *   - The tree options of the databases and how patrons are looked up can
+ *     be chosen, to compare them on the same input
  *
  */
 
@@ -15,13 +25,56 @@
 #include "bookDatabase.h"
 #include "commandFactory.h"
 #include "library.h"
+#include "lineSource.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include "patronDatabase.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
+// -------------------------------------------------------------------------
+/** LibraryBuilder()
+ * Default Constructor
+ * Creates a builder that loads records with LOAD_SERIAL
+ * @pre None.
+ * @post LibraryBuilder object exists
+ */
+LibraryBuilder::LibraryBuilder()
+{
+   loadMode = LOAD_SERIAL;
+   threadCount = 1;
+   treeOptions = TREE_BALANCED | TREE_ARENA;
+   patronLookup = LOOKUP_TABLE;
+   reportCache = true;
+}
+
+// -------------------------------------------------------------------------
+/** LibraryBuilder(mode)
+ * Constructor with load mode
+ * Creates a builder that loads records with the given mode
+ * @param mode how records are put into the databases
+ * @param threads threads LOAD_PARALLEL parses with, 0 for one per core
+ * @pre None.
+ * @post LibraryBuilder object exists
+ */
+LibraryBuilder::LibraryBuilder(LoadMode mode, int threads)
+{
+   loadMode = mode;
+   threadCount = threads;
+   if (threadCount <= 0) {
+      threadCount = max(1, (int)thread::hardware_concurrency());
+   }
+   treeOptions = TREE_BALANCED | TREE_ARENA;
+   patronLookup = LOOKUP_TABLE;
+   reportCache = true;
+}
+
 // -------------------------------------------------------------------------
 /** createLibrary()
  * Create Library Object
@@ -36,41 +89,281 @@ using namespace std;
  *         patron and book
  */
 Library* LibraryBuilder::createLibrary(istream& books, istream& patrons)
+{
+   LineSource bookLines(books);
+   LineSource patronLines(patrons);
+   return createLibrary(bookLines, patronLines);
+}
+
+// -------------------------------------------------------------------------
+/** createLibrary()
+ * Create Library Object
+ * Same as createLibrary(istream&, istream&), reading the records from
+ * LineSources, such as memory-mapped files
+ * @param books source of book lines
+ * @param patrons source of patron lines
+ * @pre None.
+ * @post None.
+ * @return Library object that includes two populated databases
+ *         patron and book
+ */
+Library* LibraryBuilder::createLibrary(LineSource& books, LineSource& patrons)
 {
    Library* newLib = new Library();
-   BookDatabase* newBookDB = new BookDatabase();
+   BookDatabase* newBookDB = new BookDatabase(treeOptions);
+   PatronDatabase* newPatronDB = new PatronDatabase(treeOptions, patronLookup);
+   newBookDB->setReportCache(reportCache);
 
-   while (!books.eof()) {
-      string line;
-      stringstream inputLine;
-      getline(books, line);
+   if (loadMode == LOAD_PARALLEL) {
+      // patrons are loaded next to the books, their output held back so it
+      // still comes after every book message
+      ostringstream patronOutput;
+      thread patronLoader([&] {
+         OutputScope toPatronOutput(patronOutput);
+         loadPatrons(patrons, newPatronDB);
+      });
+      loadBooksParallel(books, newBookDB);
+      patronLoader.join();
+      output() << patronOutput.str();
+   } else {
+      loadBooks(books, newBookDB);
+      loadPatrons(patrons, newPatronDB);
+   }
+
+   newLib->bookDB = newBookDB;
+   newLib->patronDB = newPatronDB;
+   newLib->commandFactory = new CommandFactory(newBookDB, newPatronDB);
+
+   return newLib;
+}
+
+// -------------------------------------------------------------------------
+/** setTreeOptions()
+ * Choose how the databases build their trees
+ *
+ * @param options TreeOption values combined with |
+ * @pre None.
+ * @post later libraries are built with these options. The default is
+ * TREE_BALANCED | TREE_ARENA, like the databases' default constructors
+ */
+void LibraryBuilder::setTreeOptions(int options) { treeOptions = options; }
+
+// -------------------------------------------------------------------------
+/** setPatronLookup()
+ * Choose how the patron database finds patrons
+ *
+ * @param lookup LOOKUP_TREE or LOOKUP_TABLE
+ * @pre None.
+ * @post later libraries are built with this lookup. The default is
+ * LOOKUP_TABLE
+ */
+void LibraryBuilder::setPatronLookup(PatronLookup lookup)
+{
+   patronLookup = lookup;
+}
+
+// -------------------------------------------------------------------------
+/** setReportCache()
+ * Choose whether the book database keeps its rendered report rows
+ *
+ * @param on true to keep rows between library displays
+ * @pre None.
+ * @post later libraries are built with this setting. The default is on,
+ * like BookDatabase
+ */
+void LibraryBuilder::setReportCache(bool on) { reportCache = on; }
+
+// -------------------------------------------------------------------------
+/** loadBooks()
+ * Load the books
+ *
+ * Reads every book line into bookDB, one at a time or staged, as
+ * loadMode says
+ * @param books source of book lines
+ * @param bookDB database the books go into
+ * @pre loadMode is LOAD_SERIAL or LOAD_BULK
+ * @post bookDB holds the valid books. Errors are printed
+ */
+void LibraryBuilder::loadBooks(LineSource& books, BookDatabase* bookDB) const
+{
+   // books are parsed straight out of the line
+   string_view line;
+   int staged = 0;
+   while (books.next(line)) {
       if (line.empty()) {
          continue;
       }
-      inputLine.str(line);
-      if (!newBookDB->insertNewBook(inputLine)) {
-         cout << endl;
+      bool added = loadMode == LOAD_BULK ? bookDB->stageNewBook(line)
+                                         : bookDB->insertNewBook(line);
+      if (!added) {
+         Metrics::countError(ERROR_BAD_BOOK);
+         errorOutput() << '\n';
+      } else {
+         staged++;
       }
    }
+   if (loadMode == LOAD_BULK) {
+      // the duplicates are found as the staged books are committed
+      Metrics::countError(ERROR_BAD_BOOK,
+                          staged - bookDB->commitStagedBooks());
+   }
+}
 
-   PatronDatabase* newPatronDB = new PatronDatabase();
+// error messages printed for one book line
+struct LineOutput {
+   size_t line;
+   string text;
+};
 
-   while (!patrons.eof()) {
-      string line;
-      stringstream inputLine;
-      getline(patrons, line);
+// -------------------------------------------------------------------------
+/** loadBooksParallel()
+ * Load the books on several threads
+ *
+ * Parses chunks of the lines in parallel, then adds each shelf's books
+ * on its own thread in line order, so the same copy of a duplicate wins
+ * as with LOAD_SERIAL. Each thread's error messages are captured with
+ * the line they belong to and printed in line order at the end.
+ * @param books source of book lines
+ * @param bookDB database the books go into
+ * @pre None.
+ * @post bookDB holds the valid books. Errors are printed
+ */
+void LibraryBuilder::loadBooksParallel(LineSource& books,
+                                       BookDatabase* bookDB) const
+{
+   // every non-empty line. Streamed lines are copied first, a mapped line
+   // stays valid as long as its source
+   vector<string> copies;
+   vector<string_view> lines;
+   string_view line;
+   while (books.next(line)) {
       if (line.empty()) {
          continue;
       }
-      inputLine.str(line);
-      if (!newPatronDB->insertNewPatron(inputLine)) {
-         cout << endl;
+      if (books.isMapped()) {
+         lines.push_back(line);
+      } else {
+         copies.emplace_back(line);
       }
    }
+   if (!books.isMapped()) {
+      lines.assign(copies.begin(), copies.end());
+   }
 
-   newLib->bookDB = newBookDB;
-   newLib->patronDB = newPatronDB;
-   newLib->commandFactory = new CommandFactory(newBookDB, newPatronDB);
+   int workers = (int)min((size_t)threadCount,
+                          lines.size() / MIN_LINES_PER_THREAD + 1);
+   vector<Book*> parsed(lines.size());
+   vector<vector<LineOutput>> messages(workers + HASH_SIZE);
+   // line numbers of each worker's books, by shelf, in line order
+   vector<vector<vector<size_t>>> routed(
+      workers, vector<vector<size_t>>(HASH_SIZE));
 
-   return newLib;
+   auto parse = [&](int worker) {
+      ostringstream captured;
+      OutputScope toCaptured(captured);
+      size_t end = lines.size() * (worker + 1) / workers;
+      for (size_t i = lines.size() * worker / workers; i < end; i++) {
+         parsed[i] = bookDB->parseBook(lines[i]);
+         if (parsed[i] == nullptr) {
+            Metrics::countError(ERROR_BAD_BOOK);
+            errorOutput() << '\n';
+         } else {
+            routed[worker][bookDB->getShelf(*parsed[i])].push_back(i);
+         }
+         if (captured.tellp() > 0) {
+            messages[worker].push_back({i, captured.str()});
+            captured.str("");
+         }
+      }
+   };
+   vector<thread> pool;
+   for (int worker = 1; worker < workers; worker++) {
+      pool.emplace_back(parse, worker);
+   }
+   parse(0);
+   for (thread& t : pool) {
+      t.join();
+   }
+   pool.clear();
+
+   auto fill = [&](int shelf) {
+      ostringstream captured;
+      OutputScope toCaptured(captured);
+      vector<LineOutput>& shelfMessages = messages[workers + shelf];
+      for (int worker = 0; worker < workers; worker++) {
+         for (size_t i : routed[worker][shelf]) {
+            if (!bookDB->addBook(parsed[i])) {
+               Metrics::countError(ERROR_BAD_BOOK);
+               errorOutput() << '\n';
+            }
+            if (captured.tellp() > 0) {
+               shelfMessages.push_back({i, captured.str()});
+               captured.str("");
+            }
+         }
+      }
+   };
+   for (int shelf = 0; shelf < HASH_SIZE; shelf++) {
+      for (int worker = 0; worker < workers; worker++) {
+         if (!routed[worker][shelf].empty()) {
+            pool.emplace_back(fill, shelf);
+            break;
+         }
+      }
+   }
+   for (thread& t : pool) {
+      t.join();
+   }
+
+   // a line has messages from its parse or from its shelf, never both
+   vector<LineOutput> all;
+   for (vector<LineOutput>& list : messages) {
+      for (LineOutput& message : list) {
+         all.push_back(move(message));
+      }
+   }
+   sort(all.begin(), all.end(),
+        [](const LineOutput& a, const LineOutput& b) {
+           return a.line < b.line;
+        });
+   for (const LineOutput& message : all) {
+      output() << message.text;
+   }
+}
+
+// -------------------------------------------------------------------------
+/** loadPatrons()
+ * Load the patrons
+ *
+ * Reads every patron line into patronDB, one at a time or staged, as
+ * loadMode says. LOAD_PARALLEL adds them one at a time.
+ * @param patrons source of patron lines
+ * @param patronDB database the patrons go into
+ * @pre None.
+ * @post patronDB holds the valid patrons. Errors are printed
+ */
+void LibraryBuilder::loadPatrons(LineSource& patrons,
+                                 PatronDatabase* patronDB) const
+{
+   string_view line;
+   int staged = 0;
+   while (patrons.next(line)) {
+      if (line.empty()) {
+         continue;
+      }
+      stringstream inputLine;
+      inputLine.str(string(line));
+      bool added = loadMode == LOAD_BULK ? patronDB->stageNewPatron(inputLine)
+                                         : patronDB->insertNewPatron(inputLine);
+      if (!added) {
+         Metrics::countError(ERROR_BAD_PATRON);
+         errorOutput() << '\n';
+      } else {
+         staged++;
+      }
+   }
+   if (loadMode == LOAD_BULK) {
+      Metrics::countError(ERROR_BAD_PATRON,
+                          staged - patronDB->commitStagedPatrons());
+   }
 }
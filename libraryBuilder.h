@@ -8,6 +8,16 @@
  * Implementation:
  *   - Library contents are streamed into a file
  *   - Library items operate with their own indipendent input files
+ *   - Records are either inserted one at a time as they are read, or staged
+ *     and bulk loaded once the whole file has been read (LoadMode)
+ *   - Records come from LineSources, so books are parsed straight out of
+ *     a memory-mapped file
+ *   - LOAD_PARALLEL parses books on several threads and builds every shelf
+ *     and the patron database at the same time. Error messages are kept
+ *     with their line and printed in input order, so the output is the
+ *     same as LOAD_SERIAL
+ *   - The tree options of the databases and how patrons are looked up can
+ *     be chosen, to compare them on the same input
  *
  */
 
@@ -16,13 +26,49 @@
 
 using namespace std;
 
+#include "patronDatabase.h"
 #include <iostream>
 
 class Library;
+class LineSource;
+class BookDatabase;
+class PatronDatabase;
+
+// How LibraryBuilder puts books and patrons into their databases
+enum LoadMode {
+   // insert each record as soon as its line is read
+   LOAD_SERIAL,
+   // stage every record, then sort once and build balanced trees. Duplicate
+   // messages come after the input error messages of the same file
+   LOAD_BULK,
+   // parse book lines on several threads and fill each shelf, and the patron
+   // database, on its own thread. Same databases and output as LOAD_SERIAL
+   LOAD_PARALLEL
+};
 
 class LibraryBuilder
 {
 public:
+   // -------------------------------------------------------------------------
+   /** LibraryBuilder()
+    * Default Constructor
+    * Creates a builder that loads records with LOAD_SERIAL
+    * @pre None.
+    * @post LibraryBuilder object exists
+    */
+   LibraryBuilder();
+
+   // -------------------------------------------------------------------------
+   /** LibraryBuilder(mode)
+    * Constructor with load mode
+    * Creates a builder that loads records with the given mode
+    * @param mode how records are put into the databases
+    * @param threads threads LOAD_PARALLEL parses with, 0 for one per core
+    * @pre None.
+    * @post LibraryBuilder object exists
+    */
+   explicit LibraryBuilder(LoadMode mode, int threads = 0);
+
    // -------------------------------------------------------------------------
    /** createLibrary()
     * Create Library Object
@@ -37,6 +83,111 @@ public:
     *         patron and book
     */
    Library* createLibrary(istream& books, istream& patrons);
+
+   // -------------------------------------------------------------------------
+   /** createLibrary()
+    * Create Library Object
+    * Same as createLibrary(istream&, istream&), reading the records from
+    * LineSources, such as memory-mapped files
+    * @param books source of book lines
+    * @param patrons source of patron lines
+    * @pre None.
+    * @post None.
+    * @return Library object that includes two populated databases
+    *         patron and book
+    */
+   Library* createLibrary(LineSource& books, LineSource& patrons);
+
+   // -------------------------------------------------------------------------
+   /** setTreeOptions()
+    * Choose how the databases build their trees
+    *
+    * @param options TreeOption values combined with |
+    * @pre None.
+    * @post later libraries are built with these options. The default is
+    * TREE_BALANCED | TREE_ARENA, like the databases' default constructors
+    */
+   void setTreeOptions(int options);
+
+   // -------------------------------------------------------------------------
+   /** setPatronLookup()
+    * Choose how the patron database finds patrons
+    *
+    * @param lookup LOOKUP_TREE or LOOKUP_TABLE
+    * @pre None.
+    * @post later libraries are built with this lookup. The default is
+    * LOOKUP_TABLE
+    */
+   void setPatronLookup(PatronLookup lookup);
+
+   // -------------------------------------------------------------------------
+   /** setReportCache()
+    * Choose whether the book database keeps its rendered report rows
+    *
+    * @param on true to keep rows between library displays
+    * @pre None.
+    * @post later libraries are built with this setting. The default is on,
+    * like BookDatabase
+    */
+   void setReportCache(bool on);
+
+private:
+   // how records are put into the databases
+   LoadMode loadMode;
+
+   // tree options of the databases and how patrons are found
+   int treeOptions;
+   PatronLookup patronLookup;
+
+   // whether the book database keeps its rendered report rows
+   bool reportCache;
+
+   // threads LOAD_PARALLEL parses book lines with
+   int threadCount;
+
+   // fewest book lines worth giving a thread of their own
+   static const int MIN_LINES_PER_THREAD = 1024;
+
+   // -------------------------------------------------------------------------
+   /** loadBooks()
+    * Load the books
+    *
+    * Reads every book line into bookDB, one at a time or staged, as
+    * loadMode says
+    * @param books source of book lines
+    * @param bookDB database the books go into
+    * @pre loadMode is LOAD_SERIAL or LOAD_BULK
+    * @post bookDB holds the valid books. Errors are printed
+    */
+   void loadBooks(LineSource& books, BookDatabase* bookDB) const;
+
+   // -------------------------------------------------------------------------
+   /** loadBooksParallel()
+    * Load the books on several threads
+    *
+    * Parses chunks of the lines in parallel, then adds each shelf's books
+    * on its own thread in line order, so the same copy of a duplicate wins
+    * as with LOAD_SERIAL. Each thread's error messages are captured with
+    * the line they belong to and printed in line order at the end.
+    * @param books source of book lines
+    * @param bookDB database the books go into
+    * @pre None.
+    * @post bookDB holds the valid books. Errors are printed
+    */
+   void loadBooksParallel(LineSource& books, BookDatabase* bookDB) const;
+
+   // -------------------------------------------------------------------------
+   /** loadPatrons()
+    * Load the patrons
+    *
+    * Reads every patron line into patronDB, one at a time or staged, as
+    * loadMode says. LOAD_PARALLEL adds them one at a time.
+    * @param patrons source of patron lines
+    * @param patronDB database the patrons go into
+    * @pre None.
+    * @post patronDB holds the valid patrons. Errors are printed
+    */
+   void loadPatrons(LineSource& patrons, PatronDatabase* patronDB) const;
 };
 
 #endif
@@ -13,7 +13,11 @@
 
 #include "libraryCommand.h"
 #include "book.h"
+#include "commandPool.h"
 #include "bookDatabase.h"
+#include "fieldReader.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include "patron.h"
 #include "patronDatabase.h"
 #include <iomanip>
@@ -36,6 +40,8 @@ LibraryCommand::LibraryCommand()
    bookDB = nullptr;
    type = "";
    commandCode = 0;
+   sequence = 0;
+   pool = nullptr;
 }
 
 // -------------------------------------------------------------------------
@@ -48,31 +54,56 @@ LibraryCommand::LibraryCommand()
  */
 LibraryCommand::~LibraryCommand() {}
 
+// -------------------------------------------------------------------------
+/** release()
+ * End this command
+ *
+ * Destroys the command and gives its storage back to the pool it was
+ * built in, or deletes it if it was not built in a pool. Used in place of
+ * delete for every command the factory makes.
+ * @pre the command is not used again
+ * @post the command no longer exists
+ */
+void LibraryCommand::release() const
+{
+   CommandPool* from = pool;
+   if (from == nullptr) {
+      delete this;
+      return;
+   }
+   LibraryCommand* slot = const_cast<LibraryCommand*>(this);
+   slot->~LibraryCommand();
+   from->deallocate(slot);
+}
+
 /** initialize()
  * initialize command with data
  *
  * Uses a string to put data into the command
+ * @param in the rest of the line after the command type
  * @pre string must be formatted properly
  * @post the command now contains the data from the string
  * @return string is not formmatedd correctly return false,
  * else return true
  */
-bool LibraryCommand::initialize(istream& is) // put errors here
+bool LibraryCommand::initialize(FieldReader& in) // put errors here
 {
-   string patronID, line;
-   is >> patronID;
+   string_view patronID, line;
+   in.readWord(patronID);
    patron = patronDB->getPatron(patronID);
-   is.get();
+   in.get();
    if (patron == nullptr) {
-      cout << type << " COMMAND INPUT ERROR: " << patronID
-           << " is not a recognized patron." << endl;
-      getline(is, line);
+      Metrics::countError(ERROR_UNKNOWN_PATRON);
+      errorOutput() << type << " COMMAND INPUT ERROR: " << patronID
+                    << " is not a recognized patron.\n";
       return false;
    }
-   book = bookDB->getBook(is);
+   in.rest(line);
+   book = bookDB->getBook(line);
    if (book == nullptr) {
-      cout << type << " COMMAND INPUT ERROR: "
-           << "The Book is not recognized." << endl;
+      Metrics::countError(ERROR_UNKNOWN_BOOK);
+      errorOutput() << type << " COMMAND INPUT ERROR: "
+                    << "The Book is not recognized.\n";
 
       return false;
    }
@@ -80,16 +111,30 @@ bool LibraryCommand::initialize(istream& is) // put errors here
    return true;
 }
 
+// -------------------------------------------------------------------------
+/** isBarrier()
+ * Barrier command
+ *
+ * A barrier may read or change more than its own patron and book, so
+ * it must execute after every command before it and before every
+ * command after it. False unless a derived class says otherwise.
+ * @pre None
+ * @post None. const
+ * @return true if the command is a barrier
+ */
+bool LibraryCommand::isBarrier() const { return false; }
+
 // -------------------------------------------------------------------------
 /** getType()
  * get command type
  *
- * Return the type of book
+ * Return the type of command, one of the TYPE_ command constants.
+ * Nothing is copied.
  * @pre None
  * @post None. const
- * @return char representing command type
+ * @return view of the command type name, valid for the whole program
  */
-string LibraryCommand::getType() const { return type; }
+string_view LibraryCommand::getType() const { return type; }
 
 // -------------------------------------------------------------------------
 /** display()
@@ -15,8 +15,12 @@
 #define LIBRARYCOMMAND_H
 
 #include "patronDatabase.h"
+#include <cstdint>
 #include <iostream>
+#include <string_view>
 
+class CommandPool;
+class FieldReader;
 class PatronDatabase;
 class BookDatabase;
 class Book;
@@ -25,6 +29,15 @@ using namespace std;
 
 class LibraryCommand
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
+   // builds every command in one of its pools
+   friend class CommandFactory;
+
+   // orders commands by the patron and book they use
+   friend class ParallelExecutor;
+
 public:
    // -------------------------------------------------------------------------
    /** LibraryCommand()
@@ -60,34 +73,62 @@ public:
    /** create()
     * Create Library Command (factory)
     *
-    * Create a library command of the appropriate type
+    * Create a library command of the appropriate type in slot
     * this function is pure virtual
-    * @pre None
-    * @post a new library command exists
+    * @param slot storage for the command, from the factory's CommandPool
+    * @pre slot is big enough for the derived type
+    * @post a new library command exists in slot
+    */
+   virtual LibraryCommand* create(void* slot) const = 0;
+
+   // -------------------------------------------------------------------------
+   /** release()
+    * End this command
+    *
+    * Destroys the command and gives its storage back to the pool it was
+    * built in, or deletes it if it was not built in a pool. Used in place of
+    * delete for every command the factory makes.
+    * @pre the command is not used again
+    * @post the command no longer exists
     */
-   virtual LibraryCommand* create() const = 0;
+   void release() const;
 
    /** initialize()
     * initialize command with data
     *
     * Uses a string to put data into the command
+    * @param in the rest of the line after the command type
     * @pre string must be formatted properly
     * @post the command now contains the data from the string
     * @return string is not formmatedd correctly return false,
     * else return true
     */
-   virtual bool initialize(istream& is);
+   virtual bool initialize(FieldReader& in);
+
+   // -------------------------------------------------------------------------
+   /** isBarrier()
+    * Barrier command
+    *
+    * A barrier may read or change more than its own patron and book, so
+    * it must execute after every command before it and before every
+    * command after it. False unless a derived class says otherwise.
+    * @pre None
+    * @post None. const
+    * @return true if the command is a barrier
+    */
+   virtual bool isBarrier() const;
 
    // -------------------------------------------------------------------------
    /** getType()
     * get command type
     *
-    * Return the type of book
+    * Return the type of command, one of the TYPE_ command constants.
+    * Nothing is copied.
     * @pre None
     * @post None. const
-    * @return char representing command type
+    * @return view of the command type name, valid for the whole program
     */
-   string getType() const;
+   string_view getType() const;
 
    // -------------------------------------------------------------------------
    /** display()
@@ -107,14 +148,22 @@ protected:
    // character indicating command
    char commandCode;
 
-   // Command Type
-   string type;
+   // Command Type, one of the TYPE_ command constants
+   string_view type;
 
    // ID of patron this command uses
    Patron* patron;
 
    // ID of book this command uses
    Book* book;
+
+   // position of this command among those the factory has made, kept in
+   // the patron's history with the book
+   uint32_t sequence;
+
+private:
+   // pool this command was built in, nullptr if it was made with new
+   CommandPool* pool;
 };
 
 #endif
\ No newline at end of file
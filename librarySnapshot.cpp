@@ -0,0 +1,488 @@
+/** @file librarySnapshot.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A LibrarySnapshot saves a fully built Library to a binary file and
+ *     loads it back, so a restart does not rebuild the databases from text
+ *   - Holds every book with its count, every patron with their current
+ *     checkouts and command history
+ *   - Can check that two libraries hold the same state, for example one
+ *     built from text and one loaded from a snapshot
+ *
+ * Implementation:
+ *   - The file is a fixed header (magic, version, payload size, checksum)
+ *     followed by the payload. Numbers are in the machine's byte order
+ *   - Every distinct author and title is written once, in a name table at
+ *     the front. Books are written shelf by shelf in shelf order, patrons
+ *     in ID order. Books refer to names, and checkouts and history to books,
+ *     by their position in the file. Each name is interned in the catalog's
+ *     StringPool once for all the books that use it, and books keep views
+ *     of it. Patron names are copied into each patron
+ *   - Loading maps the file, checks the header and checksum, then builds
+ *     one Book or Patron per record and copies its fields in. There is no
+ *     text to parse and no per-record search: every shelf and the patron
+ *     tree are built balanced from their already sorted records in linear
+ *     time. Each record is checked as it is read (order, counts, positions,
+ *     checkout totals), so a file that passes its checksum but holds an
+ *     impossible library is still rejected
+ *   - This is not a file used in place with its offsets fixed up. Books,
+ *     patrons and tree nodes are heap objects with virtual functions and
+ *     containers of their own, so loading still allocates and fills every
+ *     object. The format saves the parsing and searching, which is most of
+ *     the cost of a text build
+ *   - The payload of a library is canonical, so two libraries are
+ *     equivalent when their payloads are byte for byte the same
+ */
+
+#include "librarySnapshot.h"
+
+#include "book.h"
+#include "bookCompare.h"
+#include "bookDatabase.h"
+#include "commandFactory.h"
+#include "constants.h"
+#include "library.h"
+#include "libraryCommand.h"
+#include "mappedFile.h"
+#include "outputSink.h"
+#include "patron.h"
+#include "patronDatabase.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// first bytes of every snapshot file
+static const char SNAPSHOT_MAGIC[8] = {'L', 'I', 'B', 'S', 'N', 'A', 'P', 0};
+
+// magic, version, reserved, payload size, checksum
+static const size_t HEADER_SIZE = 32;
+
+// book index written for a history entry with no book
+static const uint32_t NO_BOOK = 0xFFFFFFFF;
+
+// appends a number or a length prefixed string to the payload
+template <class T>
+static void put(string& bytes, T value)
+{
+   bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void putString(string& bytes, string_view value)
+{
+   put<uint32_t>(bytes, (uint32_t)value.size());
+   bytes.append(value);
+}
+
+// reads the payload front to back. Every read checks that the bytes are
+// there, a short payload makes ok false instead of reading past the end
+struct PayloadReader {
+   const char* data;
+   size_t size;
+   size_t pos;
+   bool ok;
+
+   template <class T>
+   T get()
+   {
+      T value{};
+      if (size - pos < sizeof(value)) {
+         ok = false;
+         pos = size;
+         return value;
+      }
+      memcpy(&value, data + pos, sizeof(value));
+      pos += sizeof(value);
+      return value;
+   }
+
+   string_view getView()
+   {
+      uint32_t length = get<uint32_t>();
+      if (size - pos < length) {
+         ok = false;
+         pos = size;
+         return string_view();
+      }
+      string_view value(data + pos, length);
+      pos += length;
+      return value;
+   }
+
+   void getString(string& value) { value = getView(); }
+};
+
+// -------------------------------------------------------------------------
+/** save()
+ * Save a library
+ *
+ * @param library the library to save
+ * @param path name of the snapshot file, replaced if it exists
+ * @pre library was built by a LibraryBuilder or loaded by load
+ * @post the file holds the library's state
+ * @return false if the file could not be written
+ */
+bool LibrarySnapshot::save(const Library& library, const string& path)
+{
+   string payload;
+   writePayload(library, payload);
+
+   string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+   put<uint32_t>(header, VERSION);
+   put<uint32_t>(header, 0);
+   put<uint64_t>(header, payload.size());
+   put<uint64_t>(header, checksum(payload.data(), payload.size()));
+
+   ofstream file(path, ios::binary | ios::trunc);
+   file.write(header.data(), header.size());
+   file.write(payload.data(), payload.size());
+   file.close();
+   return !file.fail();
+}
+
+// -------------------------------------------------------------------------
+/** load()
+ * Load a library
+ *
+ * Prints a SNAPSHOT ERROR to output() if the file cannot be opened, is
+ * not a snapshot of this version, or fails its checksum. The databases
+ * are built with the given options, like LibraryBuilder's
+ * @param path name of the snapshot file
+ * @param treeOptions TreeOption values of both databases' trees
+ * @param lookup how the patron database finds patrons
+ * @param reportCache whether the book database keeps its report rows
+ * @pre None.
+ * @post None.
+ * @return the new Library, nullptr if the file was not a valid snapshot
+ */
+Library* LibrarySnapshot::load(const string& path, int treeOptions,
+                                PatronLookup lookup, bool reportCache)
+{
+   MappedFile file;
+   if (!file.map(path)) {
+      output() << "SNAPSHOT ERROR: " << path << " could not be opened.\n";
+      return nullptr;
+   }
+
+   const char* data = file.getData();
+   size_t size = file.getSize();
+   if (size < HEADER_SIZE ||
+       memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+      output() << "SNAPSHOT ERROR: " << path << " is not a snapshot.\n";
+      return nullptr;
+   }
+
+   PayloadReader header{data, HEADER_SIZE, sizeof(SNAPSHOT_MAGIC), true};
+   uint32_t version = header.get<uint32_t>();
+   header.get<uint32_t>();
+   uint64_t payloadSize = header.get<uint64_t>();
+   uint64_t sum = header.get<uint64_t>();
+   if (version != VERSION) {
+      output() << "SNAPSHOT ERROR: " << path << " has version " << version
+               << ", expected " << VERSION << ".\n";
+      return nullptr;
+   }
+   if (payloadSize != size - HEADER_SIZE ||
+       sum != checksum(data + HEADER_SIZE, payloadSize)) {
+      output() << "SNAPSHOT ERROR: " << path << " is damaged.\n";
+      return nullptr;
+   }
+
+   // the library owns the databases from the start, so deleting it cleans
+   // up whatever was loaded when the payload turns out to be bad
+   Library* library = new Library();
+   library->bookDB = new BookDatabase(treeOptions);
+   library->bookDB->setReportCache(reportCache);
+   library->patronDB = new PatronDatabase(treeOptions, lookup);
+   library->commandFactory =
+       new CommandFactory(library->bookDB, library->patronDB);
+
+   if (!readPayload(*library, data + HEADER_SIZE, payloadSize)) {
+      output() << "SNAPSHOT ERROR: " << path << " is damaged.\n";
+      delete library;
+      return nullptr;
+   }
+   return library;
+}
+
+// -------------------------------------------------------------------------
+/** equivalent()
+ * Compare two libraries
+ *
+ * Tree shapes and lookup statistics are not compared, only the books,
+ * counts, patrons, checkouts and histories
+ * @param left one library
+ * @param right the other library
+ * @pre None.
+ * @post None.
+ * @return true if both libraries hold the same state
+ */
+bool LibrarySnapshot::equivalent(const Library& left, const Library& right)
+{
+   string leftBytes;
+   string rightBytes;
+   writePayload(left, leftBytes);
+   writePayload(right, rightBytes);
+   return leftBytes == rightBytes;
+}
+
+// -------------------------------------------------------------------------
+/** writePayload()
+ * Serialize a library
+ *
+ * @param library the library to serialize
+ * @param bytes the payload is appended here
+ * @pre None.
+ * @post bytes holds the payload
+ */
+void LibrarySnapshot::writePayload(const Library& library, string& bytes)
+{
+   // position of every book in the payload, for checkouts and history
+   unordered_map<const Book*, uint32_t> bookIndex;
+
+   // every author and title once, in the order first used, and the
+   // position of each in that list
+   vector<string_view> names;
+   unordered_map<string_view, uint32_t> nameIndex;
+   auto nameOf = [&names, &nameIndex](string_view name) {
+      auto found = nameIndex.emplace(name, (uint32_t)names.size());
+      if (found.second) {
+         names.push_back(name);
+      }
+      return found.first->second;
+   };
+
+   // the books go after the name table, which is only known at the end
+   string books;
+   for (BookShelf* shelf : library.bookDB->bookShelf) {
+      put<uint32_t>(books, (uint32_t)shelf->getSize());
+      shelf->inorder([&books, &bookIndex, &nameOf](Book* book) {
+         uint32_t index = (uint32_t)bookIndex.size();
+         bookIndex[book] = index;
+         put<char>(books, book->typeCode);
+         put<int32_t>(books, book->year);
+         put<int32_t>(books, book->month);
+         put<int32_t>(books, book->count);
+         put<int32_t>(books, book->maxCount);
+         put<uint32_t>(books, nameOf(book->author));
+         put<uint32_t>(books, nameOf(book->title));
+      });
+   }
+
+   put<uint32_t>(bytes, (uint32_t)names.size());
+   for (string_view name : names) {
+      putString(bytes, name);
+   }
+   bytes.append(books);
+
+   PatronTree* patrons = library.patronDB->patronBST;
+   put<uint32_t>(bytes, (uint32_t)patrons->getSize());
+   vector<pair<uint32_t, int32_t>> checkouts;
+   patrons->inorder([&bytes, &bookIndex, &checkouts](Patron* patron) {
+      putString(bytes, patron->id);
+      putString(bytes, patron->lastName);
+      putString(bytes, patron->firstName);
+
+      // the set is unordered, sort it so equal libraries write equal bytes
+      checkouts.clear();
+      patron->currentCheckouts.forEach(
+          [&checkouts, &bookIndex](const Book* book, int copies) {
+             checkouts.emplace_back(bookIndex.at(book), copies);
+          });
+      sort(checkouts.begin(), checkouts.end());
+      put<uint32_t>(bytes, (uint32_t)checkouts.size());
+      for (const auto& entry : checkouts) {
+         put<uint32_t>(bytes, entry.first);
+         put<int32_t>(bytes, entry.second);
+      }
+
+      put<uint32_t>(bytes, (uint32_t)patron->commandHistory.size());
+      for (const Patron::HistoryEvent& event : patron->commandHistory) {
+         put<char>(bytes, event.action);
+         put<uint32_t>(bytes, event.book == nullptr
+                                  ? NO_BOOK
+                                  : bookIndex.at(event.book));
+         put<uint32_t>(bytes, event.sequence);
+      }
+   });
+
+   // so commands run after loading are numbered on from the saved ones
+   put<uint32_t>(bytes, library.commandFactory->nextSequence);
+}
+
+// -------------------------------------------------------------------------
+/** readPayload()
+ * Rebuild a library
+ *
+ * @param library an empty library to fill
+ * @param data the payload
+ * @param size bytes in the payload
+ * @pre library has empty databases and a command factory
+ * @post library holds the payload's state if it was well formed
+ * @return false if the payload ended early, referred to a missing book,
+ * held books out of order or with impossible counts, or had checkouts
+ * that do not add up to the copies missing from each shelf
+ */
+bool LibrarySnapshot::readPayload(Library& library, const char* data,
+                                  size_t size)
+{
+   PayloadReader in{data, size, 0, true};
+   BookDatabase* bookDB = library.bookDB;
+   BookFactory& factory = bookDB->bookFactory;
+
+   // the name table, each name interned once for all the books using it
+   uint32_t nameCount = in.get<uint32_t>();
+   vector<string_view> names;
+   for (uint32_t i = 0; i < nameCount && in.ok; i++) {
+      names.push_back(factory.strings.intern(in.getView()));
+   }
+   if (!in.ok) {
+      return false;
+   }
+
+   // every book in payload order, shelves one after another
+   vector<Book*> books;
+   vector<Book*> shelved;
+   BookCompare compare;
+   for (int shelf = 0; shelf < HASH_SIZE; shelf++) {
+      uint32_t count = in.get<uint32_t>();
+      shelved.clear();
+      for (uint32_t i = 0; i < count && in.ok; i++) {
+         char typeCode = in.get<char>();
+         int index = typeCode - HASH_START;
+         if (index < 0 || index >= HASH_SIZE ||
+             factory.bookTypes[index] == nullptr) {
+            in.ok = false;
+            break;
+         }
+         Book* book = factory.bookTypes[index]->create();
+         shelved.push_back(book);
+         book->year = in.get<int32_t>();
+         book->month = in.get<int32_t>();
+         book->count = in.get<int32_t>();
+         book->maxCount = in.get<int32_t>();
+         uint32_t author = in.get<uint32_t>();
+         uint32_t title = in.get<uint32_t>();
+         if (author >= names.size() || title >= names.size() ||
+             bookDB->getShelf(*book) != shelf) {
+            in.ok = false;
+            break;
+         }
+         book->author = names[author];
+         book->title = names[title];
+         // records are sorted and distinct, or the shelf would not be a
+         // search tree
+         if (book->count < 0 || book->count > book->maxCount ||
+             (i > 0 && compare(*shelved[i - 1], *book) >= 0)) {
+            in.ok = false;
+            break;
+         }
+      }
+      // arrayToTree clears the array, so keep the pointers first. The shelf
+      // owns the books from here, even when the payload is bad
+      books.insert(books.end(), shelved.begin(), shelved.end());
+      bookDB->bookShelf[shelf]->arrayToTree(shelved.data(),
+                                            (int)shelved.size());
+      if (!in.ok) {
+         return false;
+      }
+   }
+
+   PatronDatabase* patronDB = library.patronDB;
+   CommandFactory* commands = library.commandFactory;
+   uint32_t patronCount = in.get<uint32_t>();
+   vector<Patron*> patrons;
+   // copies of each book checked out, and the last patron holding it
+   vector<int64_t> held(books.size(), 0);
+   vector<uint32_t> lastHolder(books.size(), UINT32_MAX);
+   for (uint32_t i = 0; i < patronCount && in.ok; i++) {
+      Patron* patron = new Patron();
+      patrons.push_back(patron);
+      in.getString(patron->id);
+      in.getString(patron->lastName);
+      in.getString(patron->firstName);
+      if (PatronDatabase::parseID(patron->id) < 0 ||
+          (i > 0 && patrons[i - 1]->id >= patron->id)) {
+         in.ok = false;
+         break;
+      }
+
+      uint32_t checkoutCount = in.get<uint32_t>();
+      for (uint32_t c = 0; c < checkoutCount && in.ok; c++) {
+         uint32_t index = in.get<uint32_t>();
+         int32_t copies = in.get<int32_t>();
+         if (index >= books.size() || copies <= 0 ||
+             lastHolder[index] == i) {
+            in.ok = false;
+            break;
+         }
+         lastHolder[index] = i;
+         held[index] += copies;
+         patron->currentCheckouts.set(books[index], copies);
+      }
+
+      uint32_t historyCount = in.get<uint32_t>();
+      for (uint32_t h = 0; h < historyCount && in.ok; h++) {
+         char action = in.get<char>();
+         uint32_t index = in.get<uint32_t>();
+         uint32_t sequence = in.get<uint32_t>();
+         int code = action - HASH_START;
+         if (code < 0 || code >= HASH_SIZE ||
+             commands->commandTypes[code] == nullptr ||
+             (index != NO_BOOK && index >= books.size())) {
+            in.ok = false;
+            break;
+         }
+         patron->addHistory(action,
+                            index == NO_BOOK ? nullptr : books[index],
+                            sequence);
+      }
+   }
+   commands->nextSequence = in.get<uint32_t>();
+
+   // patrons are sorted by ID, the tree takes them as they are
+   patronDB->patronBST->arrayToTree(patrons.data(), (int)patrons.size());
+   if (!in.ok || in.pos != size) {
+      return false;
+   }
+   // every copy not on the shelf is held by exactly one checkout
+   for (size_t b = 0; b < books.size(); b++) {
+      if (held[b] != books[b]->maxCount - books[b]->count) {
+         return false;
+      }
+   }
+   patronDB->patronBST->inorder(
+       [patronDB](Patron* patron) { patronDB->addToTable(patron); });
+   return true;
+}
+
+// -------------------------------------------------------------------------
+/** checksum()
+ * Checksum of the payload
+ *
+ * FNV-1a over 8-byte words, then over the bytes left at the end
+ * @param data the payload
+ * @param size bytes in the payload
+ * @pre None.
+ * @post None.
+ * @return 64-bit checksum
+ */
+uint64_t LibrarySnapshot::checksum(const char* data, size_t size)
+{
+   const uint64_t PRIME = 0x100000001b3ULL;
+   uint64_t hash = 0xcbf29ce484222325ULL;
+   size_t pos = 0;
+   for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, data + pos, sizeof(word));
+      hash = (hash ^ word) * PRIME;
+   }
+   for (; pos < size; pos++) {
+      hash = (hash ^ (unsigned char)data[pos]) * PRIME;
+   }
+   return hash;
+}
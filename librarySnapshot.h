@@ -0,0 +1,143 @@
+/** @file librarySnapshot.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A LibrarySnapshot saves a fully built Library to a binary file and
+ *     loads it back, so a restart does not rebuild the databases from text
+ *   - Holds every book with its count, every patron with their current
+ *     checkouts and command history
+ *   - Can check that two libraries hold the same state, for example one
+ *     built from text and one loaded from a snapshot
+ *
+ * Implementation:
+ *   - The file is a fixed header (magic, version, payload size, checksum)
+ *     followed by the payload. Numbers are in the machine's byte order
+ *   - Every distinct author and title is written once, in a name table at
+ *     the front. Books are written shelf by shelf in shelf order, patrons
+ *     in ID order. Books refer to names, and checkouts and history to books,
+ *     by their position in the file. Each name is interned in the catalog's
+ *     StringPool once for all the books that use it, and books keep views
+ *     of it. Patron names are copied into each patron
+ *   - Loading maps the file, checks the header and checksum, then builds
+ *     one Book or Patron per record and copies its fields in. There is no
+ *     text to parse and no per-record search: every shelf and the patron
+ *     tree are built balanced from their already sorted records in linear
+ *     time. Each record is checked as it is read (order, counts, positions,
+ *     checkout totals), so a file that passes its checksum but holds an
+ *     impossible library is still rejected
+ *   - This is not a file used in place with its offsets fixed up. Books,
+ *     patrons and tree nodes are heap objects with virtual functions and
+ *     containers of their own, so loading still allocates and fills every
+ *     object. The format saves the parsing and searching, which is most of
+ *     the cost of a text build
+ *   - The payload of a library is canonical, so two libraries are
+ *     equivalent when their payloads are byte for byte the same
+ */
+
+#ifndef LIBRARYSNAPSHOT_H
+#define LIBRARYSNAPSHOT_H
+
+#include "patronDatabase.h"
+#include "sortedTree.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+class Library;
+
+class LibrarySnapshot
+{
+public:
+   // file format version written by save and accepted by load
+   static const uint32_t VERSION = 3;
+
+   // -------------------------------------------------------------------------
+   /** save()
+    * Save a library
+    *
+    * @param library the library to save
+    * @param path name of the snapshot file, replaced if it exists
+    * @pre library was built by a LibraryBuilder or loaded by load
+    * @post the file holds the library's state
+    * @return false if the file could not be written
+    */
+   static bool save(const Library& library, const string& path);
+
+   // -------------------------------------------------------------------------
+   /** load()
+    * Load a library
+    *
+    * Prints a SNAPSHOT ERROR to output() if the file cannot be opened, is
+    * not a snapshot of this version, or fails its checksum. The databases
+    * are built with the given options, like LibraryBuilder's
+    * @param path name of the snapshot file
+    * @param treeOptions TreeOption values of both databases' trees
+    * @param lookup how the patron database finds patrons
+    * @param reportCache whether the book database keeps its report rows
+    * @pre None.
+    * @post None.
+    * @return the new Library, nullptr if the file was not a valid snapshot
+    */
+   static Library* load(const string& path,
+                        int treeOptions = TREE_BALANCED | TREE_ARENA,
+                        PatronLookup lookup = LOOKUP_TABLE,
+                        bool reportCache = true);
+
+   // -------------------------------------------------------------------------
+   /** equivalent()
+    * Compare two libraries
+    *
+    * Tree shapes and lookup statistics are not compared, only the books,
+    * counts, patrons, checkouts and histories
+    * @param left one library
+    * @param right the other library
+    * @pre None.
+    * @post None.
+    * @return true if both libraries hold the same state
+    */
+   static bool equivalent(const Library& left, const Library& right);
+
+private:
+   // -------------------------------------------------------------------------
+   /** writePayload()
+    * Serialize a library
+    *
+    * @param library the library to serialize
+    * @param bytes the payload is appended here
+    * @pre None.
+    * @post bytes holds the payload
+    */
+   static void writePayload(const Library& library, string& bytes);
+
+   // -------------------------------------------------------------------------
+   /** readPayload()
+    * Rebuild a library
+    *
+    * @param library an empty library to fill
+    * @param data the payload
+    * @param size bytes in the payload
+    * @pre library has empty databases and a command factory
+    * @post library holds the payload's state if it was well formed
+    * @return false if the payload ended early, referred to a missing book,
+    * held books out of order or with impossible counts, or had checkouts
+    * that do not add up to the copies missing from each shelf
+    */
+   static bool readPayload(Library& library, const char* data, size_t size);
+
+   // -------------------------------------------------------------------------
+   /** checksum()
+    * Checksum of the payload
+    *
+    * FNV-1a over 8-byte words, then over the bytes left at the end
+    * @param data the payload
+    * @param size bytes in the payload
+    * @pre None.
+    * @post None.
+    * @return 64-bit checksum
+    */
+   static uint64_t checksum(const char* data, size_t size);
+};
+
+#endif
@@ -0,0 +1,98 @@
+/** @file lineSource.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A LineSource hands out the lines of an input file, or of a stream, one
+ *     at a time as string_views
+ *   - Used for the catalog, patron and command files, so a large command
+ *     log is never copied line by line into strings
+ *
+ * Implementation:
+ *   - A regular file is mapped read-only with a MappedFile and each line is
+ *     a slice of the mapping. Nothing is copied or allocated per line
+ *   - Anything that cannot be mapped, like a pipe, or an istream given by
+ *     the caller, is read with getline into one reused string
+ *   - Lines are split on '\n' only, exactly like getline. A last line with
+ *     no '\n' after it is still a line
+ */
+
+#include "lineSource.h"
+#include <cstring>
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** LineSource(path)
+ * Constructor for a file
+ *
+ * Maps the file if it is a regular file, otherwise opens it for streamed
+ * reading
+ * @param path name of the file
+ * @pre None.
+ * @post isOpen() tells whether the file could be opened
+ */
+LineSource::LineSource(const string& path)
+{
+   pos = 0;
+   stream = nullptr;
+
+   if (mapping.map(path)) {
+      return;
+   }
+   file.open(path);
+   if (file) {
+      stream = &file;
+   }
+}
+
+// -------------------------------------------------------------------------
+/** LineSource(is)
+ * Constructor for a stream
+ *
+ * Reads lines from is with getline
+ * @param is stream to read, must outlive the source
+ * @pre None.
+ * @post source reads from the current position of is
+ */
+LineSource::LineSource(istream& is)
+{
+   pos = 0;
+   stream = &is;
+}
+
+// -------------------------------------------------------------------------
+/** next()
+ * Read a line
+ *
+ * @param line set to the next line, without its '\n'. Valid until the
+ * next call to next(), and while the source lives if isMapped()
+ * @pre None.
+ * @post the line is consumed
+ * @return false if there are no more lines
+ */
+bool LineSource::next(string_view& line)
+{
+   if (stream != nullptr) {
+      if (!getline(*stream, buffer)) {
+         return false;
+      }
+      line = buffer;
+      return true;
+   }
+
+   const char* data = mapping.getData();
+   size_t size = mapping.getSize();
+   if (pos >= size) {
+      return false;
+   }
+   const char* start = data + pos;
+   const char* end =
+      static_cast<const char*>(memchr(start, '\n', size - pos));
+   if (end == nullptr) {
+      end = data + size;
+   }
+   line = string_view(start, end - start);
+   pos = end - data + 1;
+   return true;
+}
+
@@ -0,0 +1,98 @@
+/** @file lineSource.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A LineSource hands out the lines of an input file, or of a stream, one
+ *     at a time as string_views
+ *   - Used for the catalog, patron and command files, so a large command
+ *     log is never copied line by line into strings
+ *
+ * Implementation:
+ *   - A regular file is mapped read-only with a MappedFile and each line is
+ *     a slice of the mapping. Nothing is copied or allocated per line
+ *   - Anything that cannot be mapped, like a pipe, or an istream given by
+ *     the caller, is read with getline into one reused string
+ *   - Lines are split on '\n' only, exactly like getline. A last line with
+ *     no '\n' after it is still a line
+ */
+
+#ifndef LINESOURCE_H
+#define LINESOURCE_H
+
+#include "mappedFile.h"
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+class LineSource
+{
+public:
+   // -------------------------------------------------------------------------
+   /** LineSource(path)
+    * Constructor for a file
+    *
+    * Maps the file if it is a regular file, otherwise opens it for streamed
+    * reading
+    * @param path name of the file
+    * @pre None.
+    * @post isOpen() tells whether the file could be opened
+    */
+   explicit LineSource(const string& path);
+
+   // -------------------------------------------------------------------------
+   /** LineSource(is)
+    * Constructor for a stream
+    *
+    * Reads lines from is with getline
+    * @param is stream to read, must outlive the source
+    * @pre None.
+    * @post source reads from the current position of is
+    */
+   explicit LineSource(istream& is);
+
+   // no copies, the source owns its mapping
+   LineSource(const LineSource&) = delete;
+   LineSource& operator=(const LineSource&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** next()
+    * Read a line
+    *
+    * @param line set to the next line, without its '\n'. Valid until the
+    * next call to next(), and while the source lives if isMapped()
+    * @pre None.
+    * @post the line is consumed
+    * @return false if there are no more lines
+    */
+   bool next(string_view& line);
+
+   // -------------------------------------------------------------------------
+   /** isOpen() / isMapped()
+    * Source state
+    *
+    * isOpen() is false if the file could not be opened. isMapped() is true
+    * if lines come straight out of a memory mapping.
+    */
+   bool isOpen() const { return isMapped() || stream != nullptr; }
+   bool isMapped() const { return mapping.isMapped(); }
+
+private:
+   // the mapped file, and the position of the next line in it
+   MappedFile mapping;
+   size_t pos;
+
+   // the file when it is read as a stream instead of mapped
+   ifstream file;
+
+   // stream lines are read from, nullptr when mapped or not open
+   istream* stream;
+
+   // the last streamed line
+   string buffer;
+};
+
+#endif
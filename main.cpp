@@ -1,45 +1,442 @@
+/** @file main.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Runs the library: builds it from the book and patron files, or loads
+ *     it from a snapshot, then runs the command file
+ *   - With no options it reads data4books.txt, data4patrons.txt and
+ *     data4commands.txt and writes to standard output, as it always has
+ *   - Options choose the input files, where output goes, how the library is
+ *     loaded and how commands run, so runs can be scripted and compared
+ *
+ * Implementation:
+ *   - Options are parsed into Settings before anything runs, and a bad one
+ *     stops the run with the usage on cerr
+ *   - Everything the options add, statistics, metrics and error counts, is
+ *     written to cerr so command output is the same with or without them
+ *
+ * Usage: library [options]
+ *   --books PATH          book file, - for standard input
+ *   --patrons PATH        patron file, - for standard input
+ *   --commands PATH       command file, - for standard input
+ *   --snapshot-in PATH    load the library from a snapshot instead of the
+ *                         book and patron files
+ *   --snapshot-out PATH   save a snapshot after the commands have run
+ *   --output PATH         write output to PATH, - for standard output
+ *   --null                throw the output away
+ *   --load MODE           serial, bulk or parallel (serial)
+ *   --tree MODE           balanced or plain (balanced)
+ *   --no-arena            allocate tree nodes one at a time
+ *   --patron-lookup MODE  table or tree (table)
+ *   --no-report-cache     render every row of each library display
+ *   --run MODE            queue, stream or pipe (queue)
+ *   --window N            commands parsed ahead by stream and pipe (1024)
+ *   --execute MODE        serial or parallel (serial)
+ *   --threads N           threads of the parallel modes, 0 for one per core,
+ *                         at most 4 per core
+ *   --quiet               no error messages, only their counts on cerr
+ *   --stats               load, parse and execute times and database
+ *                         statistics on cerr
+ *   --metrics             command counts and latency percentiles on cerr
+ * Options take their value as the next argument or after '=', such as
+ * --load=bulk.
+ */
 
-
-#include <cassert>
-
-#include "BSTree.h"
-#include "bookDatabase.h"
-#include "fiction.h"
 #include "library.h"
 #include "libraryBuilder.h"
+#include "librarySnapshot.h"
+#include "lineSource.h"
+#include "metrics.h"
+#include "outputSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
 
 using namespace std;
 
-int main()
+// largest --window, so the commands parsed ahead stay a sane allocation
+static const long MAX_WINDOW = 1 << 24;
+
+// Which Library method runs the commands
+enum RunMode {
+   // parse every command into a queue, then execute them
+   RUN_QUEUE,
+   // parse and execute a window of commands at a time
+   RUN_STREAM,
+   // parse on a second thread while the commands execute
+   RUN_PIPE
+};
+
+// What parseSettings found
+enum ParseStatus {
+   // run with the settings
+   PARSE_RUN,
+   // --help, the usage was printed and there is nothing to run
+   PARSE_HELP,
+   // a bad option, printed to cerr
+   PARSE_ERROR
+};
+
+// How to run, from the command line
+struct Settings {
+   string books = "data4books.txt";
+   string patrons = "data4patrons.txt";
+   string commands = "data4commands.txt";
+   string snapshotIn;
+   string snapshotOut;
+   // "-" for standard output, "" to throw output away
+   string output = "-";
+   LoadMode load = LOAD_SERIAL;
+   int treeOptions = TREE_BALANCED | TREE_ARENA;
+   PatronLookup patronLookup = LOOKUP_TABLE;
+   bool reportCache = true;
+   RunMode run = RUN_QUEUE;
+   int window = Library::DEFAULT_WINDOW;
+   ExecuteMode execute = EXECUTE_SERIAL;
+   int threads = 0;
+   bool quiet = false;
+   bool stats = false;
+   bool metrics = false;
+};
+
+// -----------------------------------------------------------------------------
+/** usage()
+ * Print the options
+ *
+ * @param os stream the usage is written to
+ */
+void usage(ostream& os)
 {
+   os << "usage: library [options]\n"
+         "  --books PATH          book file, - for standard input\n"
+         "  --patrons PATH        patron file, - for standard input\n"
+         "  --commands PATH       command file, - for standard input\n"
+         "  --snapshot-in PATH    load the library from a snapshot\n"
+         "  --snapshot-out PATH   save a snapshot after the commands\n"
+         "  --output PATH         write output to PATH, - for stdout\n"
+         "  --null                throw the output away\n"
+         "  --load MODE           serial, bulk or parallel\n"
+         "  --tree MODE           balanced or plain\n"
+         "  --no-arena            allocate tree nodes one at a time\n"
+         "  --patron-lookup MODE  table or tree\n"
+         "  --no-report-cache     render every row of each library display\n"
+         "  --run MODE            queue, stream or pipe\n"
+         "  --window N            commands parsed ahead by stream and pipe\n"
+         "  --execute MODE        serial or parallel\n"
+         "  --threads N           threads of the parallel modes, 0 for all\n"
+         "  --quiet               no error messages, only their counts\n"
+         "  --stats               phase times and database statistics\n"
+         "  --metrics             command counts and latency percentiles\n";
+}
 
-   ifstream inBooks("data4books.txt");
-   if (!inBooks) {
-      cout << "Books file could not be opened." << endl;
-      return 1;
+// -----------------------------------------------------------------------------
+/** parseCount()
+ * Read a whole number option
+ *
+ * @param value the option's value
+ * @param low smallest value allowed
+ * @param high largest value allowed
+ * @param count receives the number
+ * @return false unless value is all digits, optionally signed, and between
+ * low and high
+ */
+bool parseCount(const string& value, long low, long high, int& count)
+{
+   if (value.empty()) {
+      return false;
    }
-   ifstream inPatrons("data4patrons.txt");
-   if (!inPatrons) {
-      cout << "Patrons file could not be opened." << endl;
-      return 1;
+   char* end = nullptr;
+   errno = 0;
+   long number = strtol(value.c_str(), &end, 10);
+   if (errno != 0 || *end != '\0' || number < low || number > high) {
+      return false;
    }
+   count = (int)number;
+   return true;
+}
 
-   LibraryBuilder build;
+// -----------------------------------------------------------------------------
+/** parseSettings()
+ * Read the command line
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param settings receives the options
+ * @return PARSE_ERROR if an option is unknown, lacks its value or has a bad
+ * one, and the problem is printed to cerr. PARSE_HELP if --help printed the
+ * usage to cout. PARSE_RUN otherwise
+ */
+ParseStatus parseSettings(int argc, char* argv[], Settings& settings)
+{
+   for (int i = 1; i < argc; i++) {
+      string name = argv[i];
+      string value;
+      bool hasValue = false;
+      size_t equals = name.find('=');
+      if (equals != string::npos) {
+         value = name.substr(equals + 1);
+         name = name.substr(0, equals);
+         hasValue = true;
+      }
+
+      // switches
+      bool* flag = name == "--quiet"     ? &settings.quiet
+                   : name == "--stats"   ? &settings.stats
+                   : name == "--metrics" ? &settings.metrics
+                                         : nullptr;
+      if (flag != nullptr || name == "--null" || name == "--no-arena" ||
+          name == "--no-report-cache" || name == "--help") {
+         if (hasValue) {
+            cerr << name << " takes no value\n";
+            return PARSE_ERROR;
+         }
+         if (flag != nullptr) {
+            *flag = true;
+         } else if (name == "--null") {
+            settings.output = "";
+         } else if (name == "--no-arena") {
+            settings.treeOptions &= ~TREE_ARENA;
+         } else if (name == "--no-report-cache") {
+            settings.reportCache = false;
+         } else {
+            usage(cout);
+            return PARSE_HELP;
+         }
+         continue;
+      }
+
+      // options with a value
+      static const string VALUED[] = {
+          "--books",         "--patrons", "--commands", "--snapshot-in",
+          "--snapshot-out",  "--output",  "--load",     "--tree",
+          "--patron-lookup", "--run",     "--window",   "--execute",
+          "--threads"};
+      if (find(begin(VALUED), end(VALUED), name) == end(VALUED)) {
+         cerr << "unknown option " << name << '\n';
+         return PARSE_ERROR;
+      }
+      if (!hasValue) {
+         if (i + 1 == argc) {
+            cerr << name << " needs a value\n";
+            return PARSE_ERROR;
+         }
+         value = argv[++i];
+      }
+      bool ok = true;
+      if (name == "--books") {
+         settings.books = value;
+      } else if (name == "--patrons") {
+         settings.patrons = value;
+      } else if (name == "--commands") {
+         settings.commands = value;
+      } else if (name == "--snapshot-in") {
+         settings.snapshotIn = value;
+      } else if (name == "--snapshot-out") {
+         settings.snapshotOut = value;
+      } else if (name == "--output") {
+         settings.output = value;
+      } else if (name == "--load") {
+         ok = value == "serial" || value == "bulk" || value == "parallel";
+         settings.load = value == "bulk"       ? LOAD_BULK
+                         : value == "parallel" ? LOAD_PARALLEL
+                                               : LOAD_SERIAL;
+      } else if (name == "--tree") {
+         ok = value == "balanced" || value == "plain";
+         if (value == "plain") {
+            settings.treeOptions &= ~TREE_BALANCED;
+         } else {
+            settings.treeOptions |= TREE_BALANCED;
+         }
+      } else if (name == "--patron-lookup") {
+         ok = value == "table" || value == "tree";
+         settings.patronLookup = value == "tree" ? LOOKUP_TREE : LOOKUP_TABLE;
+      } else if (name == "--run") {
+         ok = value == "queue" || value == "stream" || value == "pipe";
+         settings.run = value == "stream" ? RUN_STREAM
+                        : value == "pipe" ? RUN_PIPE
+                                          : RUN_QUEUE;
+      } else if (name == "--window") {
+         ok = parseCount(value, 1, MAX_WINDOW, settings.window);
+      } else if (name == "--execute") {
+         ok = value == "serial" || value == "parallel";
+         settings.execute =
+             value == "parallel" ? EXECUTE_PARALLEL : EXECUTE_SERIAL;
+      } else if (name == "--threads") {
+         long cores = max(1u, thread::hardware_concurrency());
+         ok = parseCount(value, 0, 4 * cores, settings.threads);
+      }
+      if (!ok) {
+         cerr << "bad value for " << name << ": " << value << '\n';
+         return PARSE_ERROR;
+      }
+   }
+
+   // standard input can only be read once
+   int fromInput = (settings.commands == "-") +
+                   (settings.snapshotIn.empty() && settings.books == "-") +
+                   (settings.snapshotIn.empty() && settings.patrons == "-");
+   if (fromInput > 1) {
+      cerr << "only one input can be standard input\n";
+      return PARSE_ERROR;
+   }
+   return PARSE_RUN;
+}
 
-   istream books();
-   Library* lib = build.createLibrary(inBooks, inPatrons);
+// -----------------------------------------------------------------------------
+/** openLines()
+ * Open an input
+ *
+ * @param path name of the file, - for standard input
+ * @return the source of its lines, check isOpen()
+ */
+unique_ptr<LineSource> openLines(const string& path)
+{
+   if (path == "-") {
+      return unique_ptr<LineSource>(new LineSource(cin));
+   }
+   return unique_ptr<LineSource>(new LineSource(path));
+}
 
-   ifstream inCommands("data4commands.txt");
-   if (!inCommands) {
-      cout << "Commands file could not be opened." << endl;
+// -----------------------------------------------------------------------------
+/** millisecondsSince()
+ * Elapsed time
+ *
+ * @param start time the work started
+ * @return milliseconds since start
+ */
+double millisecondsSince(chrono::steady_clock::time_point start)
+{
+   chrono::duration<double, milli> elapsed =
+       chrono::steady_clock::now() - start;
+   return elapsed.count();
+}
+
+// -----------------------------------------------------------------------------
+/** runLibrary()
+ * Load the library and run the commands
+ *
+ * @param settings the options
+ * @return the exit status, 1 if an input could not be opened or a snapshot
+ * not loaded or saved
+ */
+int runLibrary(const Settings& settings)
+{
+   auto loadStart = chrono::steady_clock::now();
+   Library* lib = nullptr;
+   if (!settings.snapshotIn.empty()) {
+      lib = LibrarySnapshot::load(settings.snapshotIn, settings.treeOptions,
+                                  settings.patronLookup,
+                                  settings.reportCache);
+      if (lib == nullptr) {
+         return 1;
+      }
+   } else {
+      unique_ptr<LineSource> inBooks = openLines(settings.books);
+      if (!inBooks->isOpen()) {
+         output() << "Books file could not be opened.\n";
+         return 1;
+      }
+      unique_ptr<LineSource> inPatrons = openLines(settings.patrons);
+      if (!inPatrons->isOpen()) {
+         output() << "Patrons file could not be opened.\n";
+         return 1;
+      }
+
+      LibraryBuilder build(settings.load, settings.threads);
+      build.setTreeOptions(settings.treeOptions);
+      build.setPatronLookup(settings.patronLookup);
+      build.setReportCache(settings.reportCache);
+      lib = build.createLibrary(*inBooks, *inPatrons);
+   }
+   double loadMs = millisecondsSince(loadStart);
+
+   unique_ptr<LineSource> inCommands = openLines(settings.commands);
+   if (!inCommands->isOpen()) {
+      output() << "Commands file could not be opened.\n";
+      delete lib;
       return 1;
    }
 
-   lib->processCommands(inCommands);
+   auto commandStart = chrono::steady_clock::now();
+   lib->setExecuteMode(settings.execute, settings.threads);
+   if (settings.run == RUN_STREAM) {
+      lib->streamCommands(*inCommands, settings.window);
+   } else if (settings.run == RUN_PIPE) {
+      lib->pipeCommands(*inCommands, settings.window);
+   } else {
+      lib->processCommands(*inCommands);
+   }
+   double commandMs = millisecondsSince(commandStart);
+   output().flush();
+
+   int status = 0;
+   if (!settings.snapshotOut.empty() &&
+       !LibrarySnapshot::save(*lib, settings.snapshotOut)) {
+      cerr << "snapshot could not be saved to " << settings.snapshotOut
+           << '\n';
+      status = 1;
+   }
 
+   if (settings.stats) {
+      ios::fmtflags oldFlags = cerr.flags();
+      cerr << fixed << setprecision(1) << "TIMING: load " << loadMs
+           << " ms, commands " << commandMs << " ms\n";
+      cerr.flags(oldFlags);
+      lib->displayStats(cerr);
+   }
+   if (settings.metrics) {
+      Metrics::display(cerr);
+   } else if (settings.quiet) {
+      Metrics::displayErrors(cerr);
+   }
    delete lib;
+   return status;
+}
+
+int main(int argc, char* argv[])
+{
+   Settings settings;
+   ParseStatus parsed = parseSettings(argc, argv, settings);
+   if (parsed == PARSE_HELP) {
+      return 0;
+   }
+   if (parsed == PARSE_ERROR) {
+      usage(cerr);
+      return 2;
+   }
+   ios::sync_with_stdio(false);
+
+   // output() goes to the chosen place for the whole run
+   NullSink nullSink;
+   ostream nowhere(&nullSink);
+   ofstream outFile;
+   unique_ptr<BufferedSink> fileSink;
+   unique_ptr<ostream> fileOut;
+   unique_ptr<OutputScope> redirect;
+   if (settings.output.empty()) {
+      redirect.reset(new OutputScope(nowhere));
+   } else if (settings.output != "-") {
+      outFile.open(settings.output);
+      if (!outFile) {
+         cerr << "cannot write to " << settings.output << '\n';
+         return 1;
+      }
+      fileSink.reset(new BufferedSink(outFile));
+      fileOut.reset(new ostream(fileSink.get()));
+      redirect.reset(new OutputScope(*fileOut));
+   }
+
+   setQuietErrors(settings.quiet);
+   Metrics::enable(settings.metrics);
+   int status = runLibrary(settings);
 
-   return 0;
+   output().flush();
+   return status;
 }
@@ -0,0 +1,104 @@
+/** @file mappedFile.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A MappedFile is a regular file mapped read-only into memory
+ *   - Used by LineSource to read input files and by LibrarySnapshot to load
+ *     a snapshot without reading it into a buffer first
+ *
+ * Implementation:
+ *   - mmap of the whole file, unmapped by the destructor
+ *   - Only regular files are mapped. The type is checked before opening, so
+ *     asking to map a pipe does not wait for its writer
+ *   - An empty file counts as mapped, with no data
+ */
+
+#include "mappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** MappedFile()
+ * Default Constructor
+ *
+ * @pre None.
+ * @post nothing is mapped
+ */
+MappedFile::MappedFile()
+{
+   data = nullptr;
+   size = 0;
+   mapped = false;
+}
+
+// -------------------------------------------------------------------------
+/** ~MappedFile()
+ * Destructor
+ *
+ * Unmaps the file. Pointers into it become invalid.
+ * @pre None.
+ * @post nothing is mapped
+ */
+MappedFile::~MappedFile() { unmap(); }
+
+// -------------------------------------------------------------------------
+/** map()
+ * Map a file
+ *
+ * Unmaps whatever was mapped before
+ * @param path name of the file
+ * @pre None.
+ * @post getData() and getSize() describe the file if it was mapped
+ * @return true if path is a regular file and was mapped
+ */
+bool MappedFile::map(const string& path)
+{
+   unmap();
+
+   // checked before opening, opening a pipe would wait for its writer
+   struct stat info;
+   if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+      return false;
+   }
+   int fd = open(path.c_str(), O_RDONLY);
+   if (fd < 0) {
+      return false;
+   }
+   if (info.st_size == 0) {
+      close(fd);
+      mapped = true;
+      return true;
+   }
+
+   void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd); // the mapping stays valid without the descriptor
+   if (mapping == MAP_FAILED) {
+      return false;
+   }
+   madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+   data = static_cast<const char*>(mapping);
+   size = info.st_size;
+   mapped = true;
+   return true;
+}
+
+// -------------------------------------------------------------------------
+/** unmap()
+ * Release the mapping
+ *
+ * @pre None.
+ * @post nothing is mapped
+ */
+void MappedFile::unmap()
+{
+   if (size > 0) {
+      munmap(const_cast<char*>(data), size);
+   }
+   data = nullptr;
+   size = 0;
+   mapped = false;
+}
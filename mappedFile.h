@@ -0,0 +1,89 @@
+/** @file mappedFile.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A MappedFile is a regular file mapped read-only into memory
+ *   - Used by LineSource to read input files and by LibrarySnapshot to load
+ *     a snapshot without reading it into a buffer first
+ *
+ * Implementation:
+ *   - mmap of the whole file, unmapped by the destructor
+ *   - Only regular files are mapped. The type is checked before opening, so
+ *     asking to map a pipe does not wait for its writer
+ *   - An empty file counts as mapped, with no data
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+class MappedFile
+{
+public:
+   // -------------------------------------------------------------------------
+   /** MappedFile()
+    * Default Constructor
+    *
+    * @pre None.
+    * @post nothing is mapped
+    */
+   MappedFile();
+
+   // -------------------------------------------------------------------------
+   /** ~MappedFile()
+    * Destructor
+    *
+    * Unmaps the file. Pointers into it become invalid.
+    * @pre None.
+    * @post nothing is mapped
+    */
+   ~MappedFile();
+
+   // no copies, the object owns its mapping
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** map()
+    * Map a file
+    *
+    * Unmaps whatever was mapped before
+    * @param path name of the file
+    * @pre None.
+    * @post getData() and getSize() describe the file if it was mapped
+    * @return true if path is a regular file and was mapped
+    */
+   bool map(const string& path);
+
+   // -------------------------------------------------------------------------
+   /** isMapped() / getData() / getSize()
+    * Mapping
+    *
+    * getData() is nullptr and getSize() 0 when nothing, or an empty file,
+    * is mapped
+    */
+   bool isMapped() const { return mapped; }
+   const char* getData() const { return data; }
+   size_t getSize() const { return size; }
+
+private:
+   // the mapping
+   const char* data;
+   size_t size;
+   bool mapped;
+
+   // -------------------------------------------------------------------------
+   /** unmap()
+    * Release the mapping
+    *
+    * @pre None.
+    * @post nothing is mapped
+    */
+   void unmap();
+};
+
+#endif
@@ -0,0 +1,265 @@
+/** @file metrics.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Metrics counts and times what the library does with its commands:
+ *     how long each line took to parse, how many commands of each type
+ *     executed and how long they took, and how many failed for each reason
+ *   - Timing is off unless enable(true) is called, and then shown by
+ *     display() as percentiles, for example at the end of a run. Errors are
+ *     always counted, so a run with quiet errors still knows how many there
+ *     were
+ *
+ * Implementation:
+ *   - Times are kept in a LatencyHistogram, HDR style: a bucket for each
+ *     nanosecond count below 16, then 16 buckets for every power of two, so
+ *     every time is kept within about 6% with a fixed number of buckets
+ *   - Counts are atomic and only ever added to, relaxed, so commands running
+ *     on several threads can record at the same time
+ *   - When off, a Metrics::Timer is one load and branch, and the clock is
+ *     never read. An error count is one relaxed add, small next to printing
+ *     the error
+ */
+
+#include "metrics.h"
+#include "constants.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+using namespace std;
+
+atomic<bool> Metrics::enabled(false);
+LatencyHistogram Metrics::histograms[METRIC_COUNT];
+atomic<long long> Metrics::errors[ERROR_TYPE_COUNT];
+
+// -------------------------------------------------------------------------
+/** LatencyHistogram()
+ * Constructor
+ *
+ * @pre None.
+ * @post histogram is empty
+ */
+LatencyHistogram::LatencyHistogram() { reset(); }
+
+// -------------------------------------------------------------------------
+/** record()
+ * Count one duration
+ *
+ * Safe to call from several threads at once
+ * @param nanoseconds the duration, longer ones count as the longest kept
+ * @pre None.
+ * @post the duration is counted
+ */
+void LatencyHistogram::record(long long nanoseconds)
+{
+   if (nanoseconds < 0) {
+      nanoseconds = 0;
+   }
+   buckets[bucketOf(nanoseconds)].fetch_add(1, memory_order_relaxed);
+   count.fetch_add(1, memory_order_relaxed);
+   total.fetch_add(nanoseconds, memory_order_relaxed);
+   long long before = longest.load(memory_order_relaxed);
+   while (nanoseconds > before &&
+          !longest.compare_exchange_weak(before, nanoseconds,
+                                         memory_order_relaxed)) {
+   }
+}
+
+// -------------------------------------------------------------------------
+/** reset()
+ * Forget every duration
+ *
+ * @pre no thread is recording
+ * @post histogram is empty
+ */
+void LatencyHistogram::reset()
+{
+   for (atomic<long long>& bucket : buckets) {
+      bucket.store(0, memory_order_relaxed);
+   }
+   count.store(0, memory_order_relaxed);
+   total.store(0, memory_order_relaxed);
+   longest.store(0, memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------------
+/** getMean()
+ * Average duration
+ *
+ * @pre None.
+ * @post None. const
+ * @return nanoseconds, 0 if nothing was counted
+ */
+double LatencyHistogram::getMean() const
+{
+   long long counted = getCount();
+   if (counted == 0) {
+      return 0;
+   }
+   return (double)total.load(memory_order_relaxed) / counted;
+}
+
+// -------------------------------------------------------------------------
+/** getPercentile()
+ * Duration a share of the counts are at or below
+ *
+ * @param percent share from 0 to 100
+ * @pre None.
+ * @post None. const
+ * @return the top of the bucket the percentile falls in, at most getMax(),
+ * 0 if nothing was counted
+ */
+long long LatencyHistogram::getPercentile(double percent) const
+{
+   long long counted = getCount();
+   if (counted == 0) {
+      return 0;
+   }
+   // the rank-th smallest duration, from 1
+   long long rank = (long long)(percent / 100 * counted + 0.5);
+   if (rank < 1) {
+      rank = 1;
+   }
+   long long seen = 0;
+   for (int bucket = 0; bucket < BUCKETS; bucket++) {
+      seen += buckets[bucket].load(memory_order_relaxed);
+      if (seen >= rank) {
+         return min(bucketTop(bucket), getMax());
+      }
+   }
+   return getMax();
+}
+
+// -------------------------------------------------------------------------
+/** bucketOf()
+ * Bucket a duration is counted in
+ *
+ * Below SUB_BUCKETS each duration has its own bucket. Above, the highest
+ * bit picks the power of two and the four bits below it pick one of its
+ * SUB_BUCKETS buckets
+ * @param nanoseconds the duration, not negative
+ * @pre None.
+ * @post None.
+ * @return the bucket, the last one for durations too long to keep
+ */
+int LatencyHistogram::bucketOf(long long nanoseconds)
+{
+   if (nanoseconds < SUB_BUCKETS) {
+      return (int)nanoseconds;
+   }
+   int power = 63 - __builtin_clzll((unsigned long long)nanoseconds);
+   if (power >= MAX_POWER) {
+      return BUCKETS - 1;
+   }
+   int sub = (int)(nanoseconds >> (power - 4)) - SUB_BUCKETS;
+   return SUB_BUCKETS + (power - 4) * SUB_BUCKETS + sub;
+}
+
+// -------------------------------------------------------------------------
+/** bucketTop()
+ * Longest duration a bucket counts
+ *
+ * @param bucket the bucket
+ * @pre 0 <= bucket < BUCKETS
+ * @post None.
+ * @return nanoseconds
+ */
+long long LatencyHistogram::bucketTop(int bucket)
+{
+   if (bucket < SUB_BUCKETS) {
+      return bucket;
+   }
+   int power = 4 + (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+   long long sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+   long long width = 1LL << (power - 4);
+   return (SUB_BUCKETS + sub) * width + width - 1;
+}
+
+// -------------------------------------------------------------------------
+/** record()
+ * Count one timed event
+ *
+ * @param event what was timed
+ * @param nanoseconds how long it took
+ * @pre None.
+ * @post the event is counted
+ */
+void Metrics::record(MetricsEvent event, long long nanoseconds)
+{
+   histograms[event].record(nanoseconds);
+}
+
+// -------------------------------------------------------------------------
+/** reset()
+ * Forget everything recorded
+ *
+ * @pre no thread is recording
+ * @post every count is 0. Timing is still on or off
+ */
+void Metrics::reset()
+{
+   for (LatencyHistogram& histogram : histograms) {
+      histogram.reset();
+   }
+   for (atomic<long long>& error : errors) {
+      error.store(0, memory_order_relaxed);
+   }
+}
+
+// -------------------------------------------------------------------------
+/** display()
+ * Print the counts and percentiles
+ *
+ * One line for parsing and one for each command type with its count and
+ * the 50th, 90th, 99th and 99.9th percentile and longest time, then the
+ * line of displayErrors()
+ * @param os stream the summary is written to
+ * @pre None.
+ * @post None.
+ */
+void Metrics::display(ostream& os)
+{
+   static const char* const EVENT_NAMES[METRIC_COUNT] = {
+       "PARSE", TYPE_CHECKOUT, TYPE_RETURN, TYPE_DISPLAY_LIB,
+       TYPE_DISPLAY_PATRON};
+   static const double PERCENTILES[] = {50, 90, 99, 99.9};
+
+   ios::fmtflags oldFlags = os.flags();
+   streamsize oldPrecision = os.precision();
+   os << fixed << setprecision(1);
+   for (int event = 0; event < METRIC_COUNT; event++) {
+      const LatencyHistogram& histogram = histograms[event];
+      os << "METRICS: " << EVENT_NAMES[event] << ' ' << histogram.getCount()
+         << ", mean " << histogram.getMean() << " ns";
+      for (double percent : PERCENTILES) {
+         os << ", p" << setprecision(percent < 99.5 ? 0 : 1) << percent
+            << ' ' << histogram.getPercentile(percent) << " ns";
+      }
+      os << setprecision(1) << ", max " << histogram.getMax() << " ns\n";
+   }
+   os.flags(oldFlags);
+   os.precision(oldPrecision);
+   displayErrors(os);
+}
+
+// -------------------------------------------------------------------------
+/** displayErrors()
+ * Print the error counts
+ *
+ * The last line of display(), on its own
+ * @param os stream the counts are written to
+ * @pre None.
+ * @post None.
+ */
+void Metrics::displayErrors(ostream& os)
+{
+   os << "METRICS: ERRORS unknown command "
+      << getErrorCount(ERROR_UNKNOWN_COMMAND) << ", unknown patron "
+      << getErrorCount(ERROR_UNKNOWN_PATRON) << ", unknown book "
+      << getErrorCount(ERROR_UNKNOWN_BOOK) << ", no copies left "
+      << getErrorCount(ERROR_NO_COPIES) << ", not checked out "
+      << getErrorCount(ERROR_NOT_CHECKED_OUT) << ", bad book lines "
+      << getErrorCount(ERROR_BAD_BOOK) << ", bad patron lines "
+      << getErrorCount(ERROR_BAD_PATRON) << '\n';
+}
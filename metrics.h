@@ -0,0 +1,272 @@
+/** @file metrics.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Metrics counts and times what the library does with its commands:
+ *     how long each line took to parse, how many commands of each type
+ *     executed and how long they took, and how many failed for each reason
+ *   - Timing is off unless enable(true) is called, and then shown by
+ *     display() as percentiles, for example at the end of a run. Errors are
+ *     always counted, so a run with quiet errors still knows how many there
+ *     were
+ *
+ * Implementation:
+ *   - Times are kept in a LatencyHistogram, HDR style: a bucket for each
+ *     nanosecond count below 16, then 16 buckets for every power of two, so
+ *     every time is kept within about 6% with a fixed number of buckets
+ *   - Counts are atomic and only ever added to, relaxed, so commands running
+ *     on several threads can record at the same time
+ *   - When off, a Metrics::Timer is one load and branch, and the clock is
+ *     never read. An error count is one relaxed add, small next to printing
+ *     the error
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+using namespace std;
+
+// What a Metrics::Timer times
+enum MetricsEvent {
+   METRIC_PARSE,
+   METRIC_CHECKOUT,
+   METRIC_RETURN,
+   METRIC_DISPLAY_LIBRARY,
+   METRIC_DISPLAY_PATRON,
+   METRIC_COUNT
+};
+
+// Why a command or input line failed, counted by Metrics::countError
+enum MetricsError {
+   // type code is not a command
+   ERROR_UNKNOWN_COMMAND,
+   // patron ID is not in the patron database
+   ERROR_UNKNOWN_PATRON,
+   // book is not in the book database, or its key could not be read
+   ERROR_UNKNOWN_BOOK,
+   // checkout of a book with no copies left
+   ERROR_NO_COPIES,
+   // return of a book the patron does not have
+   ERROR_NOT_CHECKED_OUT,
+   // book line that was not loaded: bad, or a duplicate
+   ERROR_BAD_BOOK,
+   // patron line that was not loaded: bad, or a duplicate
+   ERROR_BAD_PATRON,
+   ERROR_TYPE_COUNT
+};
+
+// -----------------------------------------------------------------------------
+/** LatencyHistogram Class
+ *
+ * Durations in nanoseconds, counted in log-linear buckets
+ */
+// -----------------------------------------------------------------------------
+class LatencyHistogram
+{
+public:
+   // -------------------------------------------------------------------------
+   /** LatencyHistogram()
+    * Constructor
+    *
+    * @pre None.
+    * @post histogram is empty
+    */
+   LatencyHistogram();
+
+   // -------------------------------------------------------------------------
+   /** record()
+    * Count one duration
+    *
+    * Safe to call from several threads at once
+    * @param nanoseconds the duration, longer ones count as the longest kept
+    * @pre None.
+    * @post the duration is counted
+    */
+   void record(long long nanoseconds);
+
+   // -------------------------------------------------------------------------
+   /** reset()
+    * Forget every duration
+    *
+    * @pre no thread is recording
+    * @post histogram is empty
+    */
+   void reset();
+
+   // -------------------------------------------------------------------------
+   /** getCount() / getMax() / getMean()
+    * Durations counted, the longest and the average, in nanoseconds
+    */
+   long long getCount() const { return count.load(memory_order_relaxed); }
+   long long getMax() const { return longest.load(memory_order_relaxed); }
+   double getMean() const;
+
+   // -------------------------------------------------------------------------
+   /** getPercentile()
+    * Duration a share of the counts are at or below
+    *
+    * @param percent share from 0 to 100
+    * @pre None.
+    * @post None. const
+    * @return the top of the bucket the percentile falls in, at most getMax(),
+    * 0 if nothing was counted
+    */
+   long long getPercentile(double percent) const;
+
+private:
+   // buckets for each power of two, and the powers of two kept
+   static const int SUB_BUCKETS = 16;
+   static const int MAX_POWER = 40;
+   static const int BUCKETS = SUB_BUCKETS * (MAX_POWER - 3);
+
+   // -------------------------------------------------------------------------
+   /** bucketOf() / bucketTop()
+    * Bucket a duration is counted in, and the longest duration it counts
+    */
+   static int bucketOf(long long nanoseconds);
+   static long long bucketTop(int bucket);
+
+   atomic<long long> buckets[BUCKETS];
+   atomic<long long> count;
+   atomic<long long> total;
+   atomic<long long> longest;
+};
+
+// -----------------------------------------------------------------------------
+/** Metrics Class
+ *
+ * The process's metrics, shared by every library and thread
+ */
+// -----------------------------------------------------------------------------
+class Metrics
+{
+public:
+   // -------------------------------------------------------------------------
+   /** enable() / isEnabled()
+    * Turn timing on or off, and whether it is on
+    */
+   static void enable(bool on) { enabled.store(on, memory_order_relaxed); }
+   static bool isEnabled() { return enabled.load(memory_order_relaxed); }
+
+   // -------------------------------------------------------------------------
+   /** countError()
+    * Count a failed command or input line
+    *
+    * Counted whether timing is on or not
+    * @param error why it failed
+    * @param count how many failed
+    * @pre None.
+    * @post the errors are counted
+    */
+   static void countError(MetricsError error, long long count = 1)
+   {
+      errors[error].fetch_add(count, memory_order_relaxed);
+   }
+
+   // -------------------------------------------------------------------------
+   /** getErrorCount()
+    * Commands that failed for a reason
+    *
+    * @param error the reason
+    * @pre None.
+    * @post None.
+    * @return errors of that kind counted since the start or the last reset
+    */
+   static long long getErrorCount(MetricsError error)
+   {
+      return errors[error].load(memory_order_relaxed);
+   }
+
+   // -------------------------------------------------------------------------
+   /** record()
+    * Count one timed event
+    *
+    * @param event what was timed
+    * @param nanoseconds how long it took
+    * @pre None.
+    * @post the event is counted
+    */
+   static void record(MetricsEvent event, long long nanoseconds);
+
+   // -------------------------------------------------------------------------
+   /** reset()
+    * Forget everything recorded
+    *
+    * @pre no thread is recording
+    * @post every count is 0. Timing is still on or off
+    */
+   static void reset();
+
+   // -------------------------------------------------------------------------
+   /** display()
+    * Print the counts and percentiles
+    *
+    * One line for parsing and one for each command type with its count and
+    * the 50th, 90th, 99th and 99.9th percentile and longest time, then the
+    * line of displayErrors()
+    * @param os stream the summary is written to
+    * @pre None.
+    * @post None.
+    */
+   static void display(ostream& os);
+
+   // -------------------------------------------------------------------------
+   /** displayErrors()
+    * Print the error counts
+    *
+    * The last line of display(), on its own
+    * @param os stream the counts are written to
+    * @pre None.
+    * @post None.
+    */
+   static void displayErrors(ostream& os);
+
+   // -------------------------------------------------------------------------
+   /** Timer Class
+    *
+    * Times from its construction to the end of its scope, if timing was
+    * on when it was made
+    */
+   // -------------------------------------------------------------------------
+   class Timer
+   {
+   public:
+      explicit Timer(MetricsEvent event) : event(event), timing(isEnabled())
+      {
+         if (timing) {
+            start = chrono::steady_clock::now();
+         }
+      }
+
+      ~Timer()
+      {
+         if (timing) {
+            record(event, chrono::duration_cast<chrono::nanoseconds>(
+                              chrono::steady_clock::now() - start)
+                              .count());
+         }
+      }
+
+      Timer(const Timer&) = delete;
+      Timer& operator=(const Timer&) = delete;
+
+   private:
+      MetricsEvent event;
+      bool timing;
+      chrono::steady_clock::time_point start;
+   };
+
+private:
+   // true while timing
+   static atomic<bool> enabled;
+
+   // time of each event and count of each error
+   static LatencyHistogram histograms[METRIC_COUNT];
+   static atomic<long long> errors[ERROR_TYPE_COUNT];
+};
+
+#endif
@@ -0,0 +1,213 @@
+/** @file outputSink.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - output() is the stream every report, display and error message of the
+ *     library is written to
+ *   - By default it is a large buffer in front of cout, so a full library
+ *     dump goes out in a few big writes instead of one flush per line
+ *   - An OutputScope sends output() somewhere else for a while, for example
+ *     to a NullSink when benchmarking or to an ostringstream to capture it
+ *   - Error messages are written to errorOutput(), which is output() unless
+ *     errors are quiet, so a run can keep its reports and drop its errors
+ *
+ * Implementation:
+ *   - Each thread has its own current output stream. Threads without an
+ *     OutputScope share the default buffered stream
+ *   - Lines end with '\n', not endl. The buffer is written out when it is
+ *     full, on flush(), and when the program exits
+ */
+
+#include "outputSink.h"
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// stream set by the innermost OutputScope of this thread, nullptr if none
+static thread_local ostream* current = nullptr;
+
+// true while errorOutput() drops everything
+static bool quietErrors = false;
+
+// -------------------------------------------------------------------------
+/** output()
+ * Current output stream
+ *
+ * @pre None.
+ * @post None.
+ * @return the stream set by the innermost OutputScope on this thread, or the
+ * default buffered stream in front of cout
+ */
+ostream& output()
+{
+   if (current != nullptr) {
+      return *current;
+   }
+   // made on first use, so after cout, and destroyed (flushed) before it
+   static BufferedSink screenSink(cout);
+   static ostream screen(&screenSink);
+   return screen;
+}
+
+// -------------------------------------------------------------------------
+/** errorOutput()
+ * Stream error messages go to
+ *
+ * Error messages, and the empty line after a line or command that failed,
+ * are written here instead of to output()
+ * @pre None.
+ * @post None.
+ * @return output(), or a stream that drops everything while errors are quiet
+ */
+ostream& errorOutput()
+{
+   if (!quietErrors) {
+      return output();
+   }
+   // one per thread, so threads writing errors at once share no stream
+   static thread_local NullSink nullSink;
+   static thread_local ostream nowhere(&nullSink);
+   return nowhere;
+}
+
+// -------------------------------------------------------------------------
+/** setQuietErrors()
+ * Drop error messages
+ *
+ * @param quiet true to drop what is written to errorOutput() on every thread
+ * @pre no thread is writing errors
+ * @post errorOutput() is output(), or drops everything if quiet
+ */
+void setQuietErrors(bool quiet) { quietErrors = quiet; }
+
+// -------------------------------------------------------------------------
+/** OutputScope()
+ * Constructor
+ *
+ * @param os stream output() returns until this scope ends
+ * @pre os outlives the scope
+ * @post output() is os on this thread
+ */
+OutputScope::OutputScope(ostream& os)
+{
+   previous = current;
+   current = &os;
+}
+
+// -------------------------------------------------------------------------
+/** ~OutputScope()
+ * Destructor
+ *
+ * @pre None.
+ * @post output() is what it was before the scope
+ */
+OutputScope::~OutputScope() { current = previous; }
+
+// -------------------------------------------------------------------------
+/** BufferedSink()
+ * Constructor
+ *
+ * @param target where the output finally goes
+ * @param size bytes held before writing to target
+ * @pre target outlives the sink
+ * @post sink exists and is empty
+ */
+BufferedSink::BufferedSink(ostream& target, int size)
+    : target(target), buffer(size > 0 ? size : 1)
+{
+   setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+// -------------------------------------------------------------------------
+/** ~BufferedSink()
+ * Destructor
+ *
+ * Writes out what is left in the buffer
+ * @pre None.
+ * @post target has all the output
+ */
+BufferedSink::~BufferedSink() { sync(); }
+
+// -------------------------------------------------------------------------
+/** overflow()
+ * Buffer is full
+ *
+ * Writes the buffer to target, then stores c
+ * @param c character that did not fit, or eof
+ * @pre None.
+ * @post buffer has room
+ * @return c, or not eof when c is eof
+ */
+BufferedSink::int_type BufferedSink::overflow(int_type c)
+{
+   drain();
+   if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+      return c;
+   }
+   return traits_type::not_eof(c);
+}
+
+// -------------------------------------------------------------------------
+/** xsputn()
+ * Write n characters
+ *
+ * Copies into the buffer. A write bigger than the whole buffer goes
+ * straight to target after what is already buffered.
+ * @param s characters to write
+ * @param n number of characters
+ * @pre None.
+ * @post characters are buffered or written
+ * @return n
+ */
+streamsize BufferedSink::xsputn(const char* s, streamsize n)
+{
+   if (n <= 0) {
+      return 0;
+   }
+   if (n > (streamsize)buffer.size()) {
+      drain();
+      target.write(s, n);
+      return n;
+   }
+   if (n > epptr() - pptr()) {
+      drain();
+   }
+   memcpy(pptr(), s, n);
+   pbump((int)n);
+   return n;
+}
+
+// -------------------------------------------------------------------------
+/** sync()
+ * Flush
+ *
+ * Writes the buffer to target and flushes target
+ * @pre None.
+ * @post buffer is empty
+ * @return 0, or -1 if target failed
+ */
+int BufferedSink::sync()
+{
+   drain();
+   target.flush();
+   return target ? 0 : -1;
+}
+
+// -------------------------------------------------------------------------
+/** drain()
+ * Empty the buffer
+ *
+ * Writes the buffer to target in one write
+ * @pre None.
+ * @post buffer is empty
+ */
+void BufferedSink::drain()
+{
+   if (pptr() > pbase()) {
+      target.write(pbase(), pptr() - pbase());
+   }
+   setp(buffer.data(), buffer.data() + buffer.size());
+}
@@ -0,0 +1,170 @@
+/** @file outputSink.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - output() is the stream every report, display and error message of the
+ *     library is written to
+ *   - By default it is a large buffer in front of cout, so a full library
+ *     dump goes out in a few big writes instead of one flush per line
+ *   - An OutputScope sends output() somewhere else for a while, for example
+ *     to a NullSink when benchmarking or to an ostringstream to capture it
+ *   - Error messages are written to errorOutput(), which is output() unless
+ *     errors are quiet, so a run can keep its reports and drop its errors
+ *
+ * Implementation:
+ *   - Each thread has its own current output stream. Threads without an
+ *     OutputScope share the default buffered stream
+ *   - Lines end with '\n', not endl. The buffer is written out when it is
+ *     full, on flush(), and when the program exits
+ */
+
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+/** output()
+ * Current output stream
+ *
+ * @pre None.
+ * @post None.
+ * @return the stream set by the innermost OutputScope on this thread, or the
+ * default buffered stream in front of cout
+ */
+ostream& output();
+
+// -----------------------------------------------------------------------------
+/** errorOutput()
+ * Stream error messages go to
+ *
+ * Error messages, and the empty line after a line or command that failed,
+ * are written here instead of to output()
+ * @pre None.
+ * @post None.
+ * @return output(), or a stream that drops everything while errors are quiet
+ */
+ostream& errorOutput();
+
+// -----------------------------------------------------------------------------
+/** setQuietErrors()
+ * Drop error messages
+ *
+ * @param quiet true to drop what is written to errorOutput() on every thread
+ * @pre no thread is writing errors
+ * @post errorOutput() is output(), or drops everything if quiet
+ */
+void setQuietErrors(bool quiet);
+
+// -----------------------------------------------------------------------------
+/** OutputScope Class
+ *
+ * Sends output() on this thread to another stream until the scope ends
+ */
+// -----------------------------------------------------------------------------
+class OutputScope
+{
+public:
+   // -------------------------------------------------------------------------
+   /** OutputScope()
+    * Constructor
+    *
+    * @param os stream output() returns until this scope ends
+    * @pre os outlives the scope
+    * @post output() is os on this thread
+    */
+   explicit OutputScope(ostream& os);
+
+   // -------------------------------------------------------------------------
+   /** ~OutputScope()
+    * Destructor
+    *
+    * @pre None.
+    * @post output() is what it was before the scope
+    */
+   ~OutputScope();
+
+   OutputScope(const OutputScope&) = delete;
+   OutputScope& operator=(const OutputScope&) = delete;
+
+private:
+   // what output() returned before this scope
+   ostream* previous;
+};
+
+// -----------------------------------------------------------------------------
+/** BufferedSink Class
+ *
+ * A streambuf that collects output in a large buffer and writes it to a
+ * target stream in one write when the buffer fills or is flushed
+ */
+// -----------------------------------------------------------------------------
+class BufferedSink : public streambuf
+{
+public:
+   // default buffer size, 1MB
+   static const int DEFAULT_SIZE = 1 << 20;
+
+   // -------------------------------------------------------------------------
+   /** BufferedSink()
+    * Constructor
+    *
+    * @param target where the output finally goes
+    * @param size bytes held before writing to target
+    * @pre target outlives the sink
+    * @post sink exists and is empty
+    */
+   explicit BufferedSink(ostream& target, int size = DEFAULT_SIZE);
+
+   // -------------------------------------------------------------------------
+   /** ~BufferedSink()
+    * Destructor
+    *
+    * Writes out what is left in the buffer
+    * @pre None.
+    * @post target has all the output
+    */
+   virtual ~BufferedSink();
+
+protected:
+   // -------------------------------------------------------------------------
+   /** overflow() / xsputn() / sync()
+    * streambuf output
+    *
+    * overflow and xsputn are called when the buffer is full or for long
+    * writes. sync, called by flush(), writes the buffer and flushes target.
+    */
+   virtual int_type overflow(int_type c);
+   virtual streamsize xsputn(const char* s, streamsize n);
+   virtual int sync();
+
+private:
+   // where the output finally goes
+   ostream& target;
+
+   // output not yet written to target
+   vector<char> buffer;
+
+   // write the buffer to target and empty it
+   void drain();
+};
+
+// -----------------------------------------------------------------------------
+/** NullSink Class
+ *
+ * A streambuf that throws all output away, for measuring the library
+ * without the cost of writing its output
+ */
+// -----------------------------------------------------------------------------
+class NullSink : public streambuf
+{
+protected:
+   virtual int_type overflow(int_type c) { return traits_type::not_eof(c); }
+   virtual streamsize xsputn(const char*, streamsize n) { return n; }
+};
+
+#endif
@@ -0,0 +1,180 @@
+/** @file outputSpool.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - An OutputSpool holds back output so it can be written out later, in
+ *     one piece, after output that has to come before it
+ *   - Used by Library::streamCommands, which executes commands while it is
+ *     still parsing but must print every parse error before any command's
+ *     output, like processCommands does
+ *
+ * Implementation:
+ *   - A streambuf with a fixed buffer. Full buffers are written to a
+ *     temporary file from tmpfile(), so memory use stays the same no matter
+ *     how much is spooled
+ *   - If no temporary file can be made the output is kept in memory instead
+ */
+
+#include "outputSpool.h"
+#include <cstring>
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** OutputSpool()
+ * Default Constructor
+ *
+ * Creates an empty spool. The temporary file is made on first use.
+ * @pre None.
+ * @post spool exists and is empty
+ */
+OutputSpool::OutputSpool()
+{
+   file = nullptr;
+   fileTried = false;
+   size = 0;
+   setp(buffer, buffer + BUFFER_SIZE);
+}
+
+// -------------------------------------------------------------------------
+/** ~OutputSpool()
+ * Destructor
+ *
+ * Closes and removes the temporary file. Output not yet copied is lost.
+ * @pre None.
+ * @post spool is deleted
+ */
+OutputSpool::~OutputSpool()
+{
+   if (file != nullptr) {
+      fclose(file);
+   }
+}
+
+// -------------------------------------------------------------------------
+/** copyTo()
+ * Write out the spooled output
+ *
+ * Writes everything spooled so far to os, in order, and empties the spool
+ * @param os where the output goes
+ * @pre None.
+ * @post os has the output. spool is empty
+ */
+void OutputSpool::copyTo(ostream& os)
+{
+   drain();
+   if (file != nullptr) {
+      rewind(file);
+      size_t count;
+      while ((count = fread(buffer, 1, BUFFER_SIZE, file)) > 0) {
+         os.write(buffer, count);
+      }
+      // start over with an empty file
+      fclose(file);
+      file = nullptr;
+      fileTried = false;
+   }
+   os.write(memory.data(), memory.size());
+   memory.clear();
+   size = 0;
+}
+
+// -------------------------------------------------------------------------
+/** getSize()
+ * Bytes spooled
+ *
+ * @pre None.
+ * @post None.
+ * @return number of bytes spooled since the spool was last emptied
+ */
+long long OutputSpool::getSize() const { return size + (pptr() - pbase()); }
+
+// -------------------------------------------------------------------------
+/** overflow()
+ * Buffer is full
+ *
+ * Drains the buffer, then stores c
+ * @param c character that did not fit, or eof
+ * @pre None.
+ * @post buffer has room
+ * @return c, or not eof when c is eof
+ */
+OutputSpool::int_type OutputSpool::overflow(int_type c)
+{
+   drain();
+   if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+      return c;
+   }
+   return traits_type::not_eof(c);
+}
+
+// -------------------------------------------------------------------------
+/** xsputn()
+ * Write n characters
+ *
+ * Copies into the buffer, draining it each time it fills
+ * @param s characters to write
+ * @param n number of characters
+ * @pre None.
+ * @post characters are spooled
+ * @return n
+ */
+streamsize OutputSpool::xsputn(const char* s, streamsize n)
+{
+   streamsize left = n;
+   while (left > 0) {
+      if (pptr() == epptr()) {
+         drain();
+      }
+      streamsize room = epptr() - pptr();
+      streamsize count = left < room ? left : room;
+      memcpy(pptr(), s, count);
+      pbump((int)count);
+      s += count;
+      left -= count;
+   }
+   return n;
+}
+
+// -------------------------------------------------------------------------
+/** sync()
+ * Flush
+ *
+ * Does nothing. endl flushes after every line, the spool keeps buffering
+ * until the buffer is full instead
+ * @pre None.
+ * @post None.
+ * @return 0
+ */
+int OutputSpool::sync() { return 0; }
+
+// -------------------------------------------------------------------------
+/** drain()
+ * Empty the buffer
+ *
+ * Appends the buffer to the temporary file, making it if needed, or to
+ * memory if there is no file
+ * @pre None.
+ * @post buffer is empty
+ */
+void OutputSpool::drain()
+{
+   size_t count = pptr() - pbase();
+   if (count == 0) {
+      return;
+   }
+   if (!fileTried) {
+      fileTried = true;
+      file = tmpfile();
+   }
+   size_t written = 0;
+   if (file != nullptr && memory.empty()) {
+      written = fwrite(pbase(), 1, count, file);
+   }
+   // once anything is in memory everything after it goes there too
+   memory.append(pbase() + written, count - written);
+   size += count;
+   setp(buffer, buffer + BUFFER_SIZE);
+}
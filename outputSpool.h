@@ -0,0 +1,111 @@
+/** @file outputSpool.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - An OutputSpool holds back output so it can be written out later, in
+ *     one piece, after output that has to come before it
+ *   - Used by Library::streamCommands, which executes commands while it is
+ *     still parsing but must print every parse error before any command's
+ *     output, like processCommands does
+ *
+ * Implementation:
+ *   - A streambuf with a fixed buffer. Full buffers are written to a
+ *     temporary file from tmpfile(), so memory use stays the same no matter
+ *     how much is spooled
+ *   - If no temporary file can be made the output is kept in memory instead
+ */
+
+#ifndef OUTPUTSPOOL_H
+#define OUTPUTSPOOL_H
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+using namespace std;
+
+class OutputSpool : public streambuf
+{
+public:
+   // -------------------------------------------------------------------------
+   /** OutputSpool()
+    * Default Constructor
+    *
+    * Creates an empty spool. The temporary file is made on first use.
+    * @pre None.
+    * @post spool exists and is empty
+    */
+   OutputSpool();
+
+   // -------------------------------------------------------------------------
+   /** ~OutputSpool()
+    * Destructor
+    *
+    * Closes and removes the temporary file. Output not yet copied is lost.
+    * @pre None.
+    * @post spool is deleted
+    */
+   virtual ~OutputSpool();
+
+   // no copies, the spool owns its file
+   OutputSpool(const OutputSpool&) = delete;
+   OutputSpool& operator=(const OutputSpool&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** copyTo()
+    * Write out the spooled output
+    *
+    * Writes everything spooled so far to os, in order, and empties the spool
+    * @param os where the output goes
+    * @pre None.
+    * @post os has the output. spool is empty
+    */
+   void copyTo(ostream& os);
+
+   // -------------------------------------------------------------------------
+   /** getSize()
+    * Bytes spooled
+    *
+    * @pre None.
+    * @post None.
+    * @return number of bytes spooled since the spool was last emptied
+    */
+   long long getSize() const;
+
+protected:
+   // -------------------------------------------------------------------------
+   /** overflow() / xsputn() / sync()
+    * streambuf output
+    *
+    * overflow and xsputn are called by the stream when the buffer is full or
+    * for long writes. sync does nothing, so endl does not cost a write.
+    */
+   virtual int_type overflow(int_type c);
+   virtual streamsize xsputn(const char* s, streamsize n);
+   virtual int sync();
+
+private:
+   // bytes held in memory before they are written to the file
+   static const int BUFFER_SIZE = 1 << 16;
+
+   // output not yet written to the file
+   char buffer[BUFFER_SIZE];
+
+   // the temporary file, nullptr until first needed or if none can be made
+   FILE* file;
+
+   // true once tmpfile() has been tried
+   bool fileTried;
+
+   // output kept in memory when there is no file
+   string memory;
+
+   // bytes spooled
+   long long size;
+
+   // move the buffer into the file, or into memory
+   void drain();
+};
+
+#endif
@@ -0,0 +1,302 @@
+/** @file parallelExecutor.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A ParallelExecutor runs parsed commands on several threads with the
+ *     same results and the same output, byte for byte, as running them one
+ *     after another
+ *   - Used by Library when its ExecuteMode is EXECUTE_PARALLEL
+ *
+ * Implementation:
+ *   - Commands are split into runs at every barrier command (isBarrier(),
+ *     such as display library) and every SEGMENT_SIZE commands. A barrier
+ *     runs alone, after everything before it
+ *   - In a run, a command waits for the last earlier command with the same
+ *     patron and the last earlier command with the same book, so it has at
+ *     most two commands to wait for and at most two waiting on it. Commands
+ *     with nothing to wait for are ready, and each thread takes a ready
+ *     command, executes it and readies whatever was waiting on it
+ *   - Each thread's output() is captured in one buffer for the run, with
+ *     where each command's output starts and ends in it. Once the run is
+ *     done the pieces are printed in command order
+ *   - Runs shorter than MIN_PARALLEL, or a single thread, execute in order
+ *     on the calling thread, exactly like Library does in EXECUTE_SERIAL
+ */
+
+#include "parallelExecutor.h"
+#include "libraryCommand.h"
+#include "outputSink.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** ParallelExecutor()
+ * Constructor
+ *
+ * @param threads threads to execute with, 0 for one per core
+ * @pre None.
+ * @post executor exists. No thread is started until execute()
+ */
+ParallelExecutor::ParallelExecutor(int threads)
+{
+   threadCount = threads;
+   if (threadCount <= 0) {
+      threadCount = max(1, (int)thread::hardware_concurrency());
+   }
+}
+
+// -------------------------------------------------------------------------
+/** execute()
+ * Execute commands
+ *
+ * Executes every command, printing an empty line after each one that
+ * fails, like Library::executeCommands. Output goes to output() of the
+ * calling thread in command order.
+ * @param commands commands to execute, in order
+ * @pre commands were parsed by the same library, and only touch the
+ * patron and book they name unless they are barriers
+ * @post commands is empty. Every command was executed and released
+ */
+void ParallelExecutor::execute(vector<LibraryCommand*>& commands)
+{
+   int start = 0;
+   int count = (int)commands.size();
+   for (int i = 0; i < count; i++) {
+      if (commands[i]->isBarrier()) {
+         run(commands.data() + start, i - start);
+         runSerial(commands.data() + i, 1);
+         start = i + 1;
+      } else if (i + 1 - start == SEGMENT_SIZE) {
+         run(commands.data() + start, i + 1 - start);
+         start = i + 1;
+      }
+   }
+   run(commands.data() + start, count - start);
+   commands.clear();
+}
+
+// -------------------------------------------------------------------------
+/** getThreadCount()
+ * Threads used
+ *
+ * @pre None.
+ * @post None. const
+ * @return threads execute() runs commands on
+ */
+int ParallelExecutor::getThreadCount() const { return threadCount; }
+
+// -------------------------------------------------------------------------
+/** run()
+ * Execute a run of non-barrier commands
+ *
+ * Chooses runSerial or runParallel by the size of the run
+ * @param commands first command of the run
+ * @param count commands in the run, none of them a barrier
+ * @pre None.
+ * @post the commands were executed and released
+ */
+void ParallelExecutor::run(LibraryCommand** commands, int count)
+{
+   if (threadCount == 1 || count < MIN_PARALLEL) {
+      runSerial(commands, count);
+   } else {
+      runParallel(commands, count);
+   }
+}
+
+// -------------------------------------------------------------------------
+/** lastUse()
+ * Find a patron or book in a table
+ *
+ * @param table one of the LastUse tables, its size a power of two
+ * @param key the patron or book
+ * @pre table has an empty slot
+ * @post key is in the table, with index -1 if it was not before
+ * @return the key's index, to read and update
+ */
+int& ParallelExecutor::lastUse(vector<LastUse>& table, const void* key)
+{
+   size_t mask = table.size() - 1;
+   // objects are at least 16 bytes apart, spread the bits above that
+   size_t slot = ((uintptr_t)key >> 4) * 0x9E3779B97F4A7C15ull >> 20 & mask;
+   while (table[slot].key != key && table[slot].key != nullptr) {
+      slot = (slot + 1) & mask;
+   }
+   table[slot].key = key;
+   return table[slot].index;
+}
+
+// -------------------------------------------------------------------------
+/** runSerial()
+ * Execute a run in order on this thread
+ *
+ * @param commands first command of the run
+ * @param count commands in the run
+ * @pre None.
+ * @post the commands were executed and released
+ */
+void ParallelExecutor::runSerial(LibraryCommand** commands, int count)
+{
+   for (int i = 0; i < count; i++) {
+      if (!commands[i]->execute()) {
+         errorOutput() << '\n';
+      }
+   }
+}
+
+// -------------------------------------------------------------------------
+/** runParallel()
+ * Execute a run on threadCount threads
+ *
+ * @param commands first command of the run
+ * @param count commands in the run, none of them a barrier
+ * @pre None.
+ * @post the commands were executed and released. Their output was
+ * printed in order
+ */
+void ParallelExecutor::runParallel(LibraryCommand** commands, int count)
+{
+   // the commands waiting on each one, through its patron and its book,
+   // and how many each one still waits for
+   vector<int> nextByPatron(count, -1);
+   vector<int> nextByBook(count, -1);
+   unique_ptr<atomic<int>[]> waiting(new atomic<int>[count]);
+   vector<int> ready;
+   size_t tableSize = 16;
+   while (tableSize < (size_t)count * 2) {
+      tableSize *= 2;
+   }
+   lastByPatron.assign(tableSize, LastUse{nullptr, -1});
+   lastByBook.assign(tableSize, LastUse{nullptr, -1});
+   for (int i = 0; i < count; i++) {
+      int before = 0;
+      int byPatron = -1;
+      if (commands[i]->patron != nullptr) {
+         int& last = lastUse(lastByPatron, commands[i]->patron);
+         if (last >= 0) {
+            byPatron = last;
+            nextByPatron[last] = i;
+            before++;
+         }
+         last = i;
+      }
+      if (commands[i]->book != nullptr) {
+         int& last = lastUse(lastByBook, commands[i]->book);
+         // waiting once is enough when one command is both
+         if (last >= 0 && last != byPatron) {
+            nextByBook[last] = i;
+            before++;
+         }
+         last = i;
+      }
+      waiting[i].store(before, memory_order_relaxed);
+      if (before == 0) {
+         ready.push_back(i);
+      }
+   }
+   // taken from the back, so the earliest commands go first
+   reverse(ready.begin(), ready.end());
+
+   if ((int)spans.size() < count) {
+      spans.resize(count);
+   }
+   int workers = min(threadCount, count);
+   vector<ostringstream> captures(workers);
+   ostream& out = output();
+   ios::fmtflags startFlags = out.flags();
+   ios::fmtflags endFlags = startFlags;
+   atomic<int> remaining(count);
+   mutex lock;
+   condition_variable wake;
+   // threads waiting on wake, guarded by lock, so a thread that readies a
+   // command only makes a wake up call when someone is asleep
+   int sleeping = 0;
+
+   auto work = [&](int worker) {
+      ostringstream& captured = captures[worker];
+      captured.flags(startFlags);
+      OutputScope toCaptured(captured);
+      int next = -1;
+      while (true) {
+         if (next < 0) {
+            unique_lock<mutex> guard(lock);
+            while (ready.empty() && remaining.load() != 0) {
+               sleeping++;
+               wake.wait(guard);
+               sleeping--;
+            }
+            if (ready.empty()) {
+               return;
+            }
+            next = ready.back();
+            ready.pop_back();
+         }
+         int i = next;
+         next = -1;
+
+         // the command releases itself, so nothing of it is used after
+         int followers[2] = {nextByPatron[i], nextByBook[i]};
+         long long begin = captured.tellp();
+         if (!commands[i]->execute()) {
+            errorOutput() << '\n';
+         }
+         spans[i] = Span{worker, begin, (long long)captured.tellp()};
+         if (i == count - 1) {
+            endFlags = captured.flags();
+         }
+
+         // run one readied command here, hand any other to another thread
+         for (int follower : followers) {
+            if (follower < 0 || --waiting[follower] != 0) {
+               continue;
+            }
+            if (next < 0) {
+               next = follower;
+            } else {
+               lock_guard<mutex> guard(lock);
+               ready.push_back(follower);
+               if (sleeping > 0) {
+                  wake.notify_one();
+               }
+            }
+         }
+         if (--remaining == 0) {
+            lock_guard<mutex> guard(lock);
+            wake.notify_all();
+         }
+      }
+   };
+
+   vector<thread> pool;
+   for (int worker = 1; worker < workers; worker++) {
+      pool.emplace_back(work, worker);
+   }
+   work(0);
+   for (thread& t : pool) {
+      t.join();
+   }
+
+   vector<string> texts(workers);
+   for (int worker = 0; worker < workers; worker++) {
+      texts[worker] = captures[worker].str();
+   }
+   for (int i = 0; i < count; i++) {
+      const Span& span = spans[i];
+      if (span.end > span.begin) {
+         out.write(texts[span.worker].data() + span.begin,
+                   span.end - span.begin);
+      }
+   }
+   // commands set the flags they print with, so the last one's are the
+   // flags executing in order would have left
+   out.flags(endFlags);
+}
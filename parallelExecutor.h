@@ -0,0 +1,152 @@
+/** @file parallelExecutor.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A ParallelExecutor runs parsed commands on several threads with the
+ *     same results and the same output, byte for byte, as running them one
+ *     after another
+ *   - Used by Library when its ExecuteMode is EXECUTE_PARALLEL
+ *
+ * Implementation:
+ *   - Commands are split into runs at every barrier command (isBarrier(),
+ *     such as display library) and every SEGMENT_SIZE commands. A barrier
+ *     runs alone, after everything before it
+ *   - In a run, a command waits for the last earlier command with the same
+ *     patron and the last earlier command with the same book, so it has at
+ *     most two commands to wait for and at most two waiting on it. Commands
+ *     with nothing to wait for are ready, and each thread takes a ready
+ *     command, executes it and readies whatever was waiting on it
+ *   - Each thread's output() is captured in one buffer for the run, with
+ *     where each command's output starts and ends in it. Once the run is
+ *     done the pieces are printed in command order
+ *   - Runs shorter than MIN_PARALLEL, or a single thread, execute in order
+ *     on the calling thread, exactly like Library does in EXECUTE_SERIAL
+ */
+
+#ifndef PARALLELEXECUTOR_H
+#define PARALLELEXECUTOR_H
+
+#include <vector>
+
+using namespace std;
+
+class LibraryCommand;
+
+class ParallelExecutor
+{
+public:
+   // -------------------------------------------------------------------------
+   /** ParallelExecutor()
+    * Constructor
+    *
+    * @param threads threads to execute with, 0 for one per core
+    * @pre None.
+    * @post executor exists. No thread is started until execute()
+    */
+   explicit ParallelExecutor(int threads = 0);
+
+   // -------------------------------------------------------------------------
+   /** execute()
+    * Execute commands
+    *
+    * Executes every command, printing an empty line after each one that
+    * fails, like Library::executeCommands. Output goes to output() of the
+    * calling thread in command order.
+    * @param commands commands to execute, in order
+    * @pre commands were parsed by the same library, and only touch the
+    * patron and book they name unless they are barriers
+    * @post commands is empty. Every command was executed and released
+    */
+   void execute(vector<LibraryCommand*>& commands);
+
+   // -------------------------------------------------------------------------
+   /** getThreadCount()
+    * Threads used
+    *
+    * @pre None.
+    * @post None. const
+    * @return threads execute() runs commands on
+    */
+   int getThreadCount() const;
+
+private:
+   // most commands in one run, so the captured output stays bounded
+   static const int SEGMENT_SIZE = 1 << 14;
+
+   // fewest commands worth starting threads for
+   static const int MIN_PARALLEL = 256;
+
+   // threads to execute with
+   int threadCount;
+
+   // a patron or book and the last command of the run so far using it
+   struct LastUse {
+      const void* key;
+      int index;
+   };
+
+   // open addressing tables of LastUse for patrons and for books, at least
+   // twice as big as the run. Kept between runs so they are allocated once
+   vector<LastUse> lastByPatron;
+   vector<LastUse> lastByBook;
+
+   // where a command's output is: thread that ran it, first and one past
+   // the last byte in that thread's buffer
+   struct Span {
+      int worker;
+      long long begin;
+      long long end;
+   };
+
+   // output of each command of the run
+   vector<Span> spans;
+
+   // -------------------------------------------------------------------------
+   /** lastUse()
+    * Find a patron or book in a table
+    *
+    * @param table one of the LastUse tables, its size a power of two
+    * @param key the patron or book
+    * @pre table has an empty slot
+    * @post key is in the table, with index -1 if it was not before
+    * @return the key's index, to read and update
+    */
+   static int& lastUse(vector<LastUse>& table, const void* key);
+
+   // -------------------------------------------------------------------------
+   /** runSerial()
+    * Execute a run in order on this thread
+    *
+    * @param commands first command of the run
+    * @param count commands in the run
+    * @pre None.
+    * @post the commands were executed and released
+    */
+   static void runSerial(LibraryCommand** commands, int count);
+
+   // -------------------------------------------------------------------------
+   /** runParallel()
+    * Execute a run on threadCount threads
+    *
+    * @param commands first command of the run
+    * @param count commands in the run, none of them a barrier
+    * @pre None.
+    * @post the commands were executed and released. Their output was
+    * printed in order
+    */
+   void runParallel(LibraryCommand** commands, int count);
+
+   // -------------------------------------------------------------------------
+   /** run()
+    * Execute a run of non-barrier commands
+    *
+    * Chooses runSerial or runParallel by the size of the run
+    * @param commands first command of the run
+    * @param count commands in the run, none of them a barrier
+    * @pre None.
+    * @post the commands were executed and released
+    */
+   void run(LibraryCommand** commands, int count);
+};
+
+#endif
@@ -9,18 +9,38 @@
  *
  * Implementation:
  * - Some functions are virtual -of BSTData
- * - Patron History stored in a list of strings
+ * - Patron history is a contiguous log of fixed size HistoryEvents, one
+ *   per checkout or return: the command code, the book and the command's
+ *   sequence number. The command itself is released once it is logged
  *
  */
 #include "patron.h"
 #include "book.h"
-#include "libraryCommand.h"
+#include "outputSink.h"
 #include <iomanip>
-#include <list>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using namespace std;
 
+// name a history event's action is displayed with, the command type name
+static string_view historyName(char action)
+{
+   switch (action) {
+   case CHECKOUT_CODE:
+      return TYPE_CHECKOUT;
+   case RETURN_CODE:
+      return TYPE_RETURN;
+   case DISPLAY_LIB_CODE:
+      return TYPE_DISPLAY_LIB;
+   case DISPLAY_PAT_CODE:
+      return TYPE_DISPLAY_PATRON;
+   default:
+      return "";
+   }
+}
+
 // -------------------------------------------------------------------------
 /** Patron()
  * Default Constructor
@@ -60,34 +80,12 @@ Patron::Patron(string newID)
 /** ~Patron()
  * Destructor
  *
- * Deletes Patron from memory. It's empty, but apparently helps to delete
- * strings
+ * Deletes Patron from memory. The history holds no commands, so there is
+ * nothing to release
  * @pre None.
  * @post Patron instance is deleted
  */
-Patron::~Patron()
-{
-   for (const LibraryCommand* comm : commandHistory) {
-      delete comm;
-   }
-}
-
-// -------------------------------------------------------------------------
-/** compare()
- * Compare patrons
- *
- * Compare 2 patrons. Returns an integer that reflects the comparison
- * @pre None
- * @post new patron object exists
- * @return negative int if left patron < right.
- * return 0 if equal, return positive int if left > right
- */
-int Patron::compare(const Patron& rhs) const
-{
-   int comparison = id.compare(rhs.id);
-
-   return comparison;
-}
+Patron::~Patron() {}
 
 // -------------------------------------------------------------------------
 /** addBook()
@@ -103,7 +101,7 @@ int Patron::compare(const Patron& rhs) const
  */
 bool Patron::addBook(Book* book)
 {
-   currentCheckouts[book]++;
+   currentCheckouts.add(book);
 
    return true;
 }
@@ -119,12 +117,7 @@ bool Patron::addBook(Book* book)
  */
 bool Patron::removeBook(Book* book)
 {
-   if (currentCheckouts[book] <= 0) {
-
-      return false;
-   }
-   currentCheckouts[book]--;
-   return true;
+   return currentCheckouts.remove(book);
 }
 
 // -------------------------------------------------------------------------
@@ -237,9 +230,6 @@ BSTData& Patron::operator=(const BSTData& rhs)
 {
    const Patron& right = static_cast<const Patron&>(rhs);
    if (this != &right) {
-      for (const LibraryCommand* comm : commandHistory) {
-         delete comm;
-      }
       id = right.id;
       lastName = right.lastName;
       firstName = right.firstName;
@@ -265,13 +255,13 @@ bool Patron::setData(istream& is)
    is >> id;
 
    if (id.length() != 4) {
-      cout << "PATRON INPUT ERROR: ID length not 4." << endl;
+      errorOutput() << "PATRON INPUT ERROR: ID length not 4.\n";
       getline(is, line);
       return false;
    }
    for (char c : id) { // check if id is number (remove if u want to use str)
       if (!isdigit(c)) {
-         cout << "PATRON INPUT ERROR: ID not a number." << endl;
+         errorOutput() << "PATRON INPUT ERROR: ID not a number.\n";
          getline(is, line);
          return false;
       }
@@ -297,10 +287,13 @@ bool Patron::setData(istream& is)
 ostream& Patron::display(ostream& os) const
 {
    os.setf(ios::left, ios::adjustfield);
-   os << id << " " << lastName << ", " << firstName << ":" << endl;
-   for (const LibraryCommand* comm : commandHistory) {
-      comm->display(os);
-      os << endl;
+   os << id << " " << lastName << ", " << firstName << ":\n";
+   for (const HistoryEvent& event : commandHistory) {
+      if (event.book != nullptr) {
+         os << "  " << setw(COMMAND_BUFFER) << historyName(event.action);
+         event.book->displayCountless(os);
+      }
+      os << '\n';
    }
 
    return os;
@@ -310,26 +303,26 @@ ostream& Patron::display(ostream& os) const
 /** getID()
  * get ID
  *
- * returns the string id of the current patron instance
+ * returns the id of the current patron instance, without copying it
  * @pre None
  * @post None
- * @return string representing patron's unique ID
+ * @return view of the patron's unique ID, valid while the patron lives
  */
-string Patron::getID() const { return id; }
+string_view Patron::getID() const { return id; }
 
 // -------------------------------------------------------------------------
-/** addCommand
- * add command
+/** addHistory
+ * add history event
  *
- * Adds the command item to the forward list of commands that represent the
- * current patron's history of attempted commands
- * @param command command item to be inserted into the patron's history
+ * Appends one event to the end of the patron's history log
+ * @param action code of the command, CHECKOUT_CODE or RETURN_CODE
+ * @param book the book the command used
+ * @param sequence the command's sequence number
  * @pre None
- * @post command item is properly inserted into the history forward_list
+ * @post the event is the last entry of the history
  * @return None
  */
-void Patron::addCommand(LibraryCommand* command)
+void Patron::addHistory(char action, const Book* book, uint32_t sequence)
 {
-   // insert at the end of the command history singly linked list
-   commandHistory.push_back(command);
+   commandHistory.push_back(HistoryEvent{book, sequence, action});
 }
@@ -9,7 +9,9 @@
  *
  * Implementation:
  * - Some functions are virtual -of BSTData
- * - Patron History stored in a list of strings
+ * - Patron history is a contiguous log of fixed size HistoryEvents, one
+ *   per checkout or return: the command code, the book and the command's
+ *   sequence number. The command itself is released once it is logged
  *
  */
 
@@ -19,19 +21,35 @@
 using namespace std;
 
 #include "BSTData.h"
+#include "checkoutSet.h"
 #include "constants.h"
 
+#include <cstdint>
 #include <iostream>
-#include <list>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
-class LibraryCommand;
 class Book;
 
 class Patron : public BSTData
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
 public:
+   // one entry of the history: a command that succeeded for this patron
+   struct HistoryEvent {
+      // the book the command used
+      const Book* book;
+
+      // the command's sequence number, from the CommandFactory
+      uint32_t sequence;
+
+      // the command's code, CHECKOUT_CODE or RETURN_CODE
+      char action;
+   };
+
    // -------------------------------------------------------------------------
    /** Patron()
     * Default Constructor
@@ -61,8 +79,8 @@ public:
    /** ~Patron()
     * Destructor
     *
-    * Deletes Patron from memory. It's empty, but apparently helps to delete
-    * strings
+    * Deletes Patron from memory. The history holds no commands, so there is
+    * nothing to release
     * @pre None.
     * @post Patron instance is deleted
     */
@@ -202,27 +220,27 @@ public:
    /** getID()
     * get ID
     *
-    * returns the string id of the current patron instance
+    * returns the id of the current patron instance, without copying it
     * @pre None
     * @post None
-    * @return string representing patron's unique ID
+    * @return view of the patron's unique ID, valid while the patron lives
     */
-   string getID() const;
+   string_view getID() const;
 
    // -------------------------------------------------------------------------
-   /** addCommand
-    * add command
+   /** addHistory
+    * add history event
     *
-    * Adds the command item to the forward list of commands that represent the
-    * current patron's history of attempted commands
-    * @param command command item to be inserted into the patron's history
+    * Appends one event to the end of the patron's history log
+    * @param action code of the command, CHECKOUT_CODE or RETURN_CODE
+    * @param book the book the command used
+    * @param sequence the command's sequence number
     * @pre None
-    * @post command item is properly inserted into the history forward_list
+    * @post the event is the last entry of the history
     * @return None
     */
-   void addCommand(LibraryCommand* command);
+   void addHistory(char action, const Book* book, uint32_t sequence);
 
-private:
    // -------------------------------------------------------------------------
    /** compare()
     * Compare patrons
@@ -235,6 +253,7 @@ private:
     */
    int compare(const Patron& rhs) const;
 
+private:
    // id of the patron
    string id;
 
@@ -242,11 +261,33 @@ private:
    string lastName;
    string firstName;
 
-   // patron command history singly linked list
-   list<const LibraryCommand*> commandHistory;
+   // patron command history, oldest first
+   vector<HistoryEvent> commandHistory;
 
-   // patron current book checkouts unordered map (for multiple checkouts)
-   unordered_map<const Book*, int> currentCheckouts;
+   // patron current book checkouts, with copies (for multiple checkouts)
+   CheckoutSet currentCheckouts;
+};
+
+// inline so PatronCompare can inline it into patron lookups
+inline int Patron::compare(const Patron& rhs) const
+{
+   int comparison = id.compare(rhs.id);
+
+   return comparison;
+}
+
+// -----------------------------------------------------------------------------
+/** PatronCompare
+ *
+ * Three-way comparison of two patrons by ID, for the SortedTree in
+ * PatronDatabase. Calls the inline Patron::compare, no virtual calls.
+ */
+// -----------------------------------------------------------------------------
+struct PatronCompare {
+   int operator()(const Patron& lhs, const Patron& rhs) const
+   {
+      return lhs.compare(rhs);
+   }
 };
 
 #endif
\ No newline at end of file
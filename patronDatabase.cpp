@@ -8,12 +8,20 @@
  *     and retrieve a patron based on the Patron object that you pass in
  *
  * Implementation:
- *   - Database of patrons exists as a "BSTree"
+ *   - Database of patrons exists as a "BSTree", a SortedTree of Patron
+ *     ordered by PatronCompare so lookups make no virtual calls
+ *   - Patrons can also be staged and then committed in one go, which sorts
+ *     them once and rebuilds the tree perfectly balanced
+ *   - IDs are always four digits, so in LOOKUP_TABLE mode (the default)
+ *     getPatron indexes a 10000 slot table by the numeric ID instead of
+ *     searching the tree. The tree is still kept for ordered iteration
  *
  */
 #include "patronDatabase.h"
-#include "BSTree.h"
+#include "outputSink.h"
 #include "patron.h"
+#include <algorithm>
+#include <iomanip>
 
 using namespace std;
 
@@ -25,7 +33,40 @@ using namespace std;
  * @post PatronDatabase object exists
  *
  */
-PatronDatabase::PatronDatabase() { patronBST = new BSTree(); }
+PatronDatabase::PatronDatabase() : PatronDatabase(TREE_BALANCED | TREE_ARENA) {}
+
+// -------------------------------------------------------------------------
+/** PatronDatabase(treeOptions)
+ * Constructor with tree options
+ * Constructs a PatronDatabase whose tree is built with the given options.
+ * The default constructor uses TREE_BALANCED | TREE_ARENA.
+ * @param treeOptions TreeOption values combined with |
+ * @pre None.
+ * @post PatronDatabase object exists
+ */
+PatronDatabase::PatronDatabase(int treeOptions)
+    : PatronDatabase(treeOptions, LOOKUP_TABLE)
+{
+}
+
+// -------------------------------------------------------------------------
+/** PatronDatabase(treeOptions, lookup)
+ * Constructor with tree options and lookup mode
+ * Constructs a PatronDatabase whose tree is built with the given options
+ * and whose getPatron uses the given lookup. The other constructors use
+ * LOOKUP_TABLE.
+ * @param treeOptions TreeOption values combined with |
+ * @param lookup how getPatron finds a patron
+ * @pre None.
+ * @post PatronDatabase object exists
+ */
+PatronDatabase::PatronDatabase(int treeOptions, PatronLookup lookup)
+    : patronTable(PATRON_TABLE_SIZE, nullptr)
+{
+   patronBST = new PatronTree(treeOptions);
+   this->lookup = lookup;
+   tableLookups = 0;
+}
 
 // -------------------------------------------------------------------------
 /** ~PatronDatabase()
@@ -34,7 +75,13 @@ PatronDatabase::PatronDatabase() { patronBST = new BSTree(); }
  * @pre Current instance of PatronDatabase exists
  * @post All new allocations of memory are deleted
  */
-PatronDatabase::~PatronDatabase() { delete patronBST; }
+PatronDatabase::~PatronDatabase()
+{
+   delete patronBST;
+   for (Patron* patron : staged) {
+      delete patron;
+   }
+}
 
 //--------------------------------------------------------------------------
 /** createPatron(Patron customer)
@@ -56,15 +103,102 @@ bool PatronDatabase::insertNewPatron(istream& is)
    }
 
    if (!patronBST->insert(newPatron)) {
-      cout << "PATRON INPUT ERROR (DUPLICATE PATRON): Patron "
-           << newPatron->getID() << " already exists." << endl;
+      errorOutput() << "PATRON INPUT ERROR (DUPLICATE PATRON): Patron "
+                    << newPatron->getID() << " already exists.\n";
       delete newPatron;
       return false;
    }
+   addToTable(newPatron);
 
    return true;
 }
 
+//--------------------------------------------------------------------------
+/** stageNewPatron()
+ * Builds a patron from the given input and holds it until
+ * commitStagedPatrons() is called. Duplicates are not checked here.
+ * @param is patron input
+ * @pre None
+ * @post the patron is staged, if its input was valid
+ * @return true if the input was a valid patron
+ */
+bool PatronDatabase::stageNewPatron(istream& is)
+{
+   Patron* newPatron = new Patron();
+
+   if (!newPatron->setData(is)) {
+      delete newPatron;
+      return false;
+   }
+
+   staged.push_back(newPatron);
+   return true;
+}
+
+//--------------------------------------------------------------------------
+/** commitStagedPatrons()
+ * Sorts the staged patrons, merges them with the patrons already in the
+ * database and rebuilds the tree balanced in linear time. When IDs are
+ * equal the patron already in the database, or else the one staged first,
+ * is kept. Every other copy is reported with the same DUPLICATE PATRON
+ * message insertNewPatron prints, followed by a blank line, in the order
+ * the copies were staged, and deleted.
+ * @pre None
+ * @post Staged patrons are in the database. Nothing is staged.
+ * @return number of staged patrons that were added
+ */
+int PatronDatabase::commitStagedPatrons()
+{
+   // remember staging order so duplicates are reported in input order
+   vector<int> order(staged.size());
+   for (size_t i = 0; i < order.size(); i++) {
+      order[i] = (int)i;
+   }
+   PatronCompare compare;
+   stable_sort(order.begin(), order.end(), [this, &compare](int a, int b) {
+      return compare(*staged[a], *staged[b]) < 0;
+   });
+
+   vector<Patron*> shelved(patronBST->getSize());
+   patronBST->treeToArray(shelved.data());
+
+   vector<Patron*> merged;
+   vector<int> duplicates;
+   merged.reserve(shelved.size() + staged.size());
+   size_t next = 0;
+   for (int index : order) {
+      Patron* patron = staged[index];
+      while (next < shelved.size() && compare(*shelved[next], *patron) < 0) {
+         merged.push_back(shelved[next++]);
+      }
+      if (next < shelved.size() && compare(*shelved[next], *patron) == 0) {
+         merged.push_back(shelved[next++]);
+      }
+      if (!merged.empty() && compare(*merged.back(), *patron) == 0) {
+         duplicates.push_back(index);
+         continue;
+      }
+      merged.push_back(patron);
+      addToTable(patron);
+   }
+   while (next < shelved.size()) {
+      merged.push_back(shelved[next++]);
+   }
+
+   patronBST->arrayToTree(merged.data(), (int)merged.size());
+
+   sort(duplicates.begin(), duplicates.end());
+   for (int index : duplicates) {
+      errorOutput() << "PATRON INPUT ERROR (DUPLICATE PATRON): Patron "
+                    << staged[index]->getID() << " already exists.\n\n";
+      delete staged[index];
+   }
+
+   int added = (int)(staged.size() - duplicates.size());
+   staged.clear();
+   return added;
+}
+
 //--------------------------------------------------------------------------
 /** getPatron(String patronId)
  * Return a Patron object based on the information that is passed in
@@ -74,11 +208,123 @@ bool PatronDatabase::insertNewPatron(istream& is)
  * @return Patron* representing the Patron object that they are looking for if
  * found
  */
-Patron* PatronDatabase::getPatron(string patronId) const
+Patron* PatronDatabase::getPatron(string_view patronId) const
 {
-   Patron patronFinder(patronId);
-   BSTData* foundPatron = nullptr;
+   if (lookup == LOOKUP_TABLE) {
+      tableLookups++;
+      int patronNumber = parseID(patronId);
+      return patronNumber < 0 ? nullptr : patronTable[patronNumber];
+   }
+
+   Patron patronFinder{string(patronId)};
+   Patron* foundPatron = nullptr;
    patronBST->retrieve(patronFinder, foundPatron);
 
-   return (Patron*)foundPatron;
+   return foundPatron;
+}
+
+//--------------------------------------------------------------------------
+/** getPatron(int patronNumber)
+ * Return the patron whose ID has the given numeric value, straight from
+ * the table, no matter the lookup mode
+ * @param patronNumber numeric value of the ID, 0 to PATRON_TABLE_SIZE - 1
+ * @pre None.
+ * @post None. const function
+ * @return Patron* with that ID, nullptr if there is none
+ */
+Patron* PatronDatabase::getPatron(int patronNumber) const
+{
+   if (patronNumber < 0 || patronNumber >= PATRON_TABLE_SIZE) {
+      return nullptr;
+   }
+   return patronTable[patronNumber];
+}
+
+//--------------------------------------------------------------------------
+/** parseID()
+ * Numeric value of an ID
+ * @param patronId ID as written in the input
+ * @pre None.
+ * @post None.
+ * @return the value of the ID, -1 unless it is exactly PATRON_ID_LENGTH
+ * digits
+ */
+int PatronDatabase::parseID(string_view patronId)
+{
+   if (patronId.length() != PATRON_ID_LENGTH) {
+      return -1;
+   }
+   int patronNumber = 0;
+   for (char c : patronId) {
+      if (c < '0' || c > '9') {
+         return -1;
+      }
+      patronNumber = patronNumber * 10 + (c - '0');
+   }
+   return patronNumber;
+}
+
+//--------------------------------------------------------------------------
+/** forEachPatron()
+ * Calls visit with every patron, in order of ID
+ * @param visit function or lambda taking a Patron*
+ * @pre None.
+ * @post None. const function
+ */
+void PatronDatabase::forEachPatron(const function<void(Patron*)>& visit) const
+{
+   patronBST->inorder(visit);
+}
+
+//--------------------------------------------------------------------------
+/** addToTable()
+ * Puts patron in the table slot of its ID. Patron::setData only accepts
+ * four digit IDs, so every patron has a slot.
+ * @param patron patron that was just added to the tree
+ * @pre patron is in the tree
+ * @post getPatron(patron's ID) returns patron
+ */
+void PatronDatabase::addToTable(Patron* patron)
+{
+   int patronNumber = parseID(patron->getID());
+   if (patronNumber >= 0) {
+      patronTable[patronNumber] = patron;
+   }
+}
+
+//--------------------------------------------------------------------------
+/** displayStats() const
+ * Displays the number of patrons, the height of the patron tree and the
+ * average comparisons per lookup, or the number of table lookups in
+ * LOOKUP_TABLE mode
+ * @param os stream the statistics are written to
+ * @pre None.
+ * @post None. const function
+ */
+void PatronDatabase::displayStats(ostream& os) const
+{
+   ios::fmtflags oldFlags = os.flags();
+   streamsize oldPrecision = os.precision();
+   os << fixed << setprecision(1);
+
+   if (lookup == LOOKUP_TABLE) {
+      os << "PATRONS: " << patronBST->getSize() << " patrons, height "
+         << patronBST->getHeight() << ", " << tableLookups
+         << " table lookups\n";
+      os.flags(oldFlags);
+      os.precision(oldPrecision);
+      return;
+   }
+
+   double perLookup = 0;
+   if (patronBST->getRetrieveCount() > 0) {
+      perLookup = (double)patronBST->getTotalComparisons() /
+                  patronBST->getRetrieveCount();
+   }
+   os << "PATRONS: " << patronBST->getSize() << " patrons, height "
+      << patronBST->getHeight() << ", " << perLookup
+      << " comparisons per lookup\n";
+
+   os.flags(oldFlags);
+   os.precision(oldPrecision);
 }
\ No newline at end of file
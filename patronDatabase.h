@@ -8,7 +8,13 @@
  *     and retrieve a patron based on the Patron object that you pass in
  *
  * Implementation:
- *   - Database of patrons exists as a "BSTree"
+ *   - Database of patrons exists as a "BSTree", a SortedTree of Patron
+ *     ordered by PatronCompare so lookups make no virtual calls
+ *   - Patrons can also be staged and then committed in one go, which sorts
+ *     them once and rebuilds the tree perfectly balanced
+ *   - IDs are always four digits, so in LOOKUP_TABLE mode (the default)
+ *     getPatron indexes a 10000 slot table by the numeric ID instead of
+ *     searching the tree. The tree is still kept for ordered iteration
  *
  */
 
@@ -16,17 +22,34 @@
 #define PATRONDATABASE_H
 
 #include "constants.h"
+#include "sortedTree.h"
 
+#include <functional>
 #include <istream>
+#include <string_view>
 #include <vector>
 
 using namespace std;
 
 class Patron;
-class BSTree;
+struct PatronCompare;
+
+// the tree patrons are kept in, ordered by ID
+typedef SortedTree<Patron, PatronCompare> PatronTree;
+
+// How getPatron finds a patron
+enum PatronLookup {
+   // search the patron tree by ID
+   LOOKUP_TREE,
+   // index a table by the numeric value of the ID
+   LOOKUP_TABLE
+};
 
 class PatronDatabase
 {
+   // rebuilds the private state when loading a snapshot
+   friend class LibrarySnapshot;
+
 public:
    // -------------------------------------------------------------------------
    /** PatronDatabase()
@@ -38,6 +61,30 @@ public:
     */
    PatronDatabase();
 
+   // -------------------------------------------------------------------------
+   /** PatronDatabase(treeOptions)
+    * Constructor with tree options
+    * Constructs a PatronDatabase whose tree is built with the given options.
+    * The default constructor uses TREE_BALANCED | TREE_ARENA.
+    * @param treeOptions TreeOption values combined with |
+    * @pre None.
+    * @post PatronDatabase object exists
+    */
+   explicit PatronDatabase(int treeOptions);
+
+   // -------------------------------------------------------------------------
+   /** PatronDatabase(treeOptions, lookup)
+    * Constructor with tree options and lookup mode
+    * Constructs a PatronDatabase whose tree is built with the given options
+    * and whose getPatron uses the given lookup. The other constructors use
+    * LOOKUP_TABLE.
+    * @param treeOptions TreeOption values combined with |
+    * @param lookup how getPatron finds a patron
+    * @pre None.
+    * @post PatronDatabase object exists
+    */
+   PatronDatabase(int treeOptions, PatronLookup lookup);
+
    // -------------------------------------------------------------------------
    /** ~PatronDatabase()
     * Destructor
@@ -58,6 +105,31 @@ public:
     */
    bool insertNewPatron(istream& is);
 
+   //--------------------------------------------------------------------------
+   /** stageNewPatron()
+    * Builds a patron from the given input and holds it until
+    * commitStagedPatrons() is called. Duplicates are not checked here.
+    * @param is patron input
+    * @pre None
+    * @post the patron is staged, if its input was valid
+    * @return true if the input was a valid patron
+    */
+   bool stageNewPatron(istream& is);
+
+   //--------------------------------------------------------------------------
+   /** commitStagedPatrons()
+    * Sorts the staged patrons, merges them with the patrons already in the
+    * database and rebuilds the tree balanced in linear time. When IDs are
+    * equal the patron already in the database, or else the one staged first,
+    * is kept. Every other copy is reported with the same DUPLICATE PATRON
+    * message insertNewPatron prints, followed by a blank line, in the order
+    * the copies were staged, and deleted.
+    * @pre None
+    * @post Staged patrons are in the database. Nothing is staged.
+    * @return number of staged patrons that were added
+    */
+   int commitStagedPatrons();
+
    //--------------------------------------------------------------------------
    /** getPatron(String patronId)
     * Return a Patron object based on the information that is passed in
@@ -67,12 +139,69 @@ public:
     * @return Patron* representing the Patron object that they are looking for
     * if found
     */
-   Patron* getPatron(string patronId) const;
+   Patron* getPatron(string_view patronId) const;
+
+   //--------------------------------------------------------------------------
+   /** getPatron(int patronNumber)
+    * Return the patron whose ID has the given numeric value, straight from
+    * the table, no matter the lookup mode
+    * @param patronNumber numeric value of the ID, 0 to PATRON_TABLE_SIZE - 1
+    * @pre None.
+    * @post None. const function
+    * @return Patron* with that ID, nullptr if there is none
+    */
+   Patron* getPatron(int patronNumber) const;
+
+   //--------------------------------------------------------------------------
+   /** parseID()
+    * Numeric value of an ID
+    * @param patronId ID as written in the input
+    * @pre None.
+    * @post None.
+    * @return the value of the ID, -1 unless it is exactly PATRON_ID_LENGTH
+    * digits
+    */
+   static int parseID(string_view patronId);
+
+   //--------------------------------------------------------------------------
+   /** forEachPatron()
+    * Calls visit with every patron, in order of ID
+    * @param visit function or lambda taking a Patron*
+    * @pre None.
+    * @post None. const function
+    */
+   void forEachPatron(const function<void(Patron*)>& visit) const;
+
+   //--------------------------------------------------------------------------
+   /** displayStats() const
+    * Displays the number of patrons, the height of the patron tree and the
+    * average comparisons per lookup, or the number of table lookups in
+    * LOOKUP_TABLE mode
+    * @param os stream the statistics are written to
+    * @pre None.
+    * @post None. const function
+    */
+   void displayStats(ostream& os) const;
 
 private:
    // the variable below is a class member variable
    // this is a BST of patrons
-   BSTree* patronBST;
+   PatronTree* patronBST;
+
+   // patrons indexed by the numeric value of their ID
+   vector<Patron*> patronTable;
+
+   // how getPatron finds a patron
+   PatronLookup lookup;
+
+   // number of getPatron calls answered from the table
+   mutable long long tableLookups;
+
+   // put patron in its table slot
+   void addToTable(Patron* patron);
+
+   // patrons waiting for commitStagedPatrons, in the order they were staged
+   vector<Patron*> staged;
 };
 
 #endif
\ No newline at end of file
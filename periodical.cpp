@@ -11,10 +11,10 @@
 #include "periodical.h"
 #include "BSTData.h"
 #include "book.h"
+#include "bookKey.h"
+#include "fieldReader.h"
+#include "outputSink.h"
 #include <iomanip>
-#include <sstream>
-
-#include <regex>
 
 using namespace std;
 
@@ -46,28 +46,6 @@ Periodical::Periodical()
  */
 Book* Periodical::create() const { return new Periodical(); }
 
-// -------------------------------------------------------------------------
-/** compare()
- * Compare periodical books
- *
- * Compare 2 periodical books. Returns an integer that reflects the comparison
- * @param rhs Book to be compared
- * @pre None
- * @post new periodical book object exists
- * @return negative int if left book < right.
- * return 0 if equal, return positive int if left > right
- */
-int Periodical::compare(const Periodical& rhs) const
-{
-   int comparison = year - rhs.year;
-   if (comparison == 0) {
-      comparison = month - rhs.month;
-      if (comparison == 0)
-         comparison = title.compare(rhs.title);
-   }
-   return comparison;
-}
-
 // -------------------------------------------------------------------------
 /** operator<()
  * Operator less than overload
@@ -170,7 +148,9 @@ bool Periodical::operator>=(const BSTData& rhs) const
 /** operator=()
  * Copy assignment operator
  *
- * Copy data from right hand item to left hand item.
+ * Copy data from right hand item to left hand item. The author and title
+ * are copied into storage this book owns, so it does not depend on rhs or
+ * its factory's pool.
  * @param rhs Book who's data will be duplicated
  * @pre Items should not be the same item
  * @post left item contains data from rhs, right item is const
@@ -180,75 +160,115 @@ BSTData& Periodical::operator=(const BSTData& rhs)
 {
    const Periodical& right = static_cast<const Periodical&>(rhs);
    if (this != &right) {
-      author = right.author;
-      title = right.title;
+      setNames(right.author, right.title);
       year = right.year;
+      month = right.month;
    }
    return *this;
 }
 
 // -------------------------------------------------------------------------
-/** setData()
- * input data into node
+/** parseKey()
+ * Parse a book key
  *
- * Take data from inputStream and put into node members
- * @param is stream line of data for book
- * @pre must have a properly formatted input file
- * @post line of input is read. BSTData contains line data
- * @return true if line of data was read, false if no line or bad format
+ * Parses the rest of a book line with the book's checks and error
+ * messages. Book::setData and BookFactory::createKey both use it. The
+ * command form is recognized by isCommandForm instead of a regex, so
+ * nothing is allocated.
+ * @param in the rest of the line after the type code
+ * @param key set to the book's identifying fields
+ * @pre None
+ * @post the line is read. key holds its data if it was valid
+ * @return true if the line was valid, false if bad format
  */
-bool Periodical::setData(istream& is)
-{ // ERRORS
+bool Periodical::parseKey(FieldReader& in, BookKey& key) const
+{
+   string_view line;
+   key.typeCode = typeCode;
+   key.type = type;
 
-   string line;
-   is.get();
-   char form = is.get();
-   if (is.peek() == ' ') {
+   in.get();
+   char form = in.get();
+   if (in.peek() == ' ') {
       if (form != format) {
-         cout << type << " BOOK INPUT ERROR: " << form
-              << " is not a recognized format." << endl;
-         getline(is, line);
+         errorOutput() << type << " BOOK INPUT ERROR: " << form
+                       << " is not a recognized format.\n";
          return false;
       }
-      is.get();
+      in.get();
    } else {
-      is.unget();
+      in.unget();
    }
 
-   getline(is, line);
-   regex commandReg("\\d{1,4}\\s\\d\\d?\\s.*");
-   stringstream data;
-
-   if (regex_match(line, commandReg)) { // command
+   in.rest(line);
+   FieldReader data(line);
 
-      data.str(line);
-      data >> year;
-      data >> month;
+   if (isCommandForm(line)) { // command
+      data.readInt(key.year);
+      data.readInt(key.month);
       data.get();
-      getline(data, title, ',');
+      data.getline(key.title, ',');
 
    } else {
-      data.str(line);
-      getline(data, title, ',');
-      data >> month;
-      data >> year;
+      data.getline(key.title, ',');
+      data.readInt(key.month);
+      data.readInt(key.year);
    }
-   if (month < 1 || month > 12) {
-      cout << TYPE_PERIODICAL << " BOOK INPUT ERROR: For book titled " << endl
-           << title.substr(0, TITLE_MAX_LENGTH) << ","
-           << " month " << month << " is not a valid month." << endl;
+   if (key.month < 1 || key.month > 12) {
+      errorOutput() << TYPE_PERIODICAL
+                    << " BOOK INPUT ERROR: For book titled \n"
+                    << key.title.substr(0, TITLE_MAX_LENGTH) << ","
+                    << " month " << key.month << " is not a valid month.\n";
       return false;
    }
-   if (year < 0) {
-      cout << TYPE_PERIODICAL << " BOOK INPUT ERROR: For book titled" << endl
-           << title.substr(0, TITLE_MAX_LENGTH) << ","
-           << " year " << year << " is not a valid year." << endl;
+   if (key.year < 0) {
+      errorOutput() << TYPE_PERIODICAL << " BOOK INPUT ERROR: For book titled\n"
+                    << key.title.substr(0, TITLE_MAX_LENGTH) << ","
+                    << " year " << key.year << " is not a valid year.\n";
       return false;
    }
 
    return true;
 }
 
+// -------------------------------------------------------------------------
+/** isCommandForm()
+ * Is this the command form of a periodical?
+ *
+ * Matches line against the regex \d{1,4}\s\d\d?\s.* by hand: up to 4
+ * digits, a space, 1 or 2 digits, a space, then anything but a line
+ * break
+ * @param line the periodical's data after the type and format
+ * @pre None
+ * @post None
+ * @return true if line is year month title, false if title, month year
+ */
+bool Periodical::isCommandForm(string_view line)
+{
+   auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+   auto isSpace = [](char c) {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+             c == '\r';
+   };
+
+   size_t pos = 0;
+   while (pos < line.size() && isDigit(line[pos])) {
+      pos++;
+   }
+   if (pos < 1 || pos > 4 || pos == line.size() || !isSpace(line[pos])) {
+      return false;
+   }
+   size_t start = ++pos;
+   while (pos < line.size() && isDigit(line[pos])) {
+      pos++;
+   }
+   if (pos - start < 1 || pos - start > 2 || pos == line.size() ||
+       !isSpace(line[pos])) {
+      return false;
+   }
+   return line.find_first_of("\n\r", pos + 1) == string_view::npos;
+}
+
 // -------------------------------------------------------------------------
 /** display()
  * Display book information
@@ -304,7 +324,7 @@ ostream& Periodical::displayHeader(ostream& os) const
 {
    os.setf(ios::left, ios::adjustfield);
 
-   os << type << " BOOKS" << endl;
+   os << type << " BOOKS\n";
    os << setw(COUNT_BUFFER) << "AVAIL" << setw(MONTH_BUFFER) << "MONTH"
       << setw(YEAR_BUFFER) << "YEAR" << setw(TITLE_BUFFER) << "TITLE";
 
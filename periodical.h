@@ -12,6 +12,7 @@
 #define PERIODICAL_H
 
 #include "book.h"
+#include "bookKey.h"
 #include "constants.h"
 #include <string>
 
@@ -122,7 +123,9 @@ public:
    /** operator=()
     * Copy assignment operator
     *
-    * Copy data from right hand item to left hand item.
+    * Copy data from right hand item to left hand item. The author and title
+    * are copied into storage this book owns, so it does not depend on rhs or
+    * its factory's pool.
     * @param rhs Book who's data will be duplicated
     * @pre Items should not be the same item
     * @post left item contains data from rhs, right item is const
@@ -130,18 +133,6 @@ public:
     */
    virtual BSTData& operator=(const BSTData& rhs);
 
-   // -------------------------------------------------------------------------
-   /** setData()
-    * input data into node
-    *
-    * Take data from inputStream and put into node members
-    * @param is stream line of data for book
-    * @pre must have a properly formatted input file
-    * @post line of input is read. BSTData contains line data
-    * @return true if line of data was read, false if no line or bad format
-    */
-   virtual bool setData(istream& is);
-
    // -------------------------------------------------------------------------
    /** display()
     * Display book information
@@ -180,7 +171,33 @@ public:
     */
    virtual ostream& displayHeader(ostream&) const;
 
-private:
+   // -------------------------------------------------------------------------
+   /** parseKey()
+    * Parse a book key
+    *
+    * Parses the rest of a book line with the book's checks and error
+    * messages. Book::setData and BookFactory::createKey both use it
+    * @param in the rest of the line after the type code
+    * @param key set to the book's identifying fields
+    * @pre None
+    * @post the line is read. key holds its data if it was valid
+    * @return true if the line was valid, false if bad format
+    */
+   virtual bool parseKey(FieldReader& in, BookKey& key) const;
+
+   // -------------------------------------------------------------------------
+   /** compareKey()
+    * Compare a key with this book
+    *
+    * Same ordering as compare(), with the key on the left
+    * @param key key to be compared, of this book's type
+    * @pre None
+    * @post None. const
+    * @return negative int if key < this book.
+    * return 0 if equal, return positive int if key > this book
+    */
+   int compareKey(const BookKey& key) const;
+
    // -------------------------------------------------------------------------
    /** compare()
     * Compare periodical books
@@ -195,8 +212,47 @@ private:
     */
    int compare(const Periodical& rhs) const;
 
+   // -------------------------------------------------------------------------
+   /** isCommandForm()
+    * Is this the command form of a periodical?
+    *
+    * Matches line against the regex \d{1,4}\s\d\d?\s.* by hand: up to 4
+    * digits, a space, 1 or 2 digits, a space, then anything but a line
+    * break
+    * @param line the periodical's data after the type and format
+    * @pre None
+    * @post None
+    * @return true if line is year month title, false if title, month year
+    */
+   static bool isCommandForm(string_view line);
+
+private:
    // current patrons checking out the book. max size is maxCount
    Patron* checkouts[5];
 };
 
+// inline so BookCompare can inline it into shelf lookups. Views of the
+// same text are equal without comparing the text
+inline int Periodical::compare(const Periodical& rhs) const
+{
+   int comparison = year - rhs.year;
+   if (comparison == 0) {
+      comparison = month - rhs.month;
+      if (comparison == 0 && !sameView(title, rhs.title))
+         comparison = title.compare(rhs.title);
+   }
+   return comparison;
+}
+
+inline int Periodical::compareKey(const BookKey& key) const
+{
+   int comparison = key.year - year;
+   if (comparison == 0) {
+      comparison = key.month - month;
+      if (comparison == 0)
+         comparison = key.title.compare(title);
+   }
+   return comparison;
+}
+
 #endif
\ No newline at end of file
@@ -14,9 +14,12 @@
 #include "bookDatabase.h"
 #include "constants.h"
 #include "libraryCommand.h"
+#include "metrics.h"
+#include "outputSink.h"
 #include "patron.h"
 #include <iostream>
 #include <string>
+#include <new>
 
 // -------------------------------------------------------------------------
 /** ReturnBook()
@@ -45,37 +48,42 @@ ReturnBook::ReturnBook(BookDatabase* books, PatronDatabase* patrons)
  */
 bool ReturnBook::execute()
 {
-
+   Metrics::Timer timer(METRIC_RETURN);
    if (!patron->removeBook(book)) {
-      cout << "RETURN COMMAND EXECUTION ERROR: Patron " << patron->getID()
-           << " Can't return book" << endl
-           << "because they did not checkout book titled: " << endl
-           << book->getTitle().substr(0, TITLE_MAX_LENGTH) << endl;
+      Metrics::countError(ERROR_NOT_CHECKED_OUT);
+      errorOutput() << "RETURN COMMAND EXECUTION ERROR: Patron "
+                    << patron->getID() << " Can't return book\n"
+                    << "because they did not checkout book titled: \n"
+                    << book->getTitle().substr(0, TITLE_MAX_LENGTH) << '\n';
 
-      delete this;
+      release();
       return false;
    }
    if (!book->addBook()) { // this error should never happen.
-      cout << "RETURN COMMAND EXECUTION ERROR: Patron " << patron->getID()
-           << "Can't return book, library contains max books titled: " << endl
-           << book->getTitle().substr(0, TITLE_MAX_LENGTH) << endl;
+      errorOutput() << "RETURN COMMAND EXECUTION ERROR: Patron "
+                    << patron->getID()
+                    << "Can't return book, library contains max books "
+                       "titled: \n"
+                    << book->getTitle().substr(0, TITLE_MAX_LENGTH) << '\n';
       patron->addBook(book); // undo patron remove book.
-      delete this;
+      release();
       return false;
    }
-   patron->addCommand(this); // if all functions successfull, store command
+   // if all functions successfull, store command in the patron's history
+   patron->addHistory(commandCode, book, sequence);
+   release();
    return true;
 }
 
 /** create()
  * Create Library Command (factory)
  *
- * Create a library command of the appropriate type
- * this function is pure virtual
- * @pre None
- * @post a new library command exists
+ * Create a library command of the appropriate type in slot
+ * @param slot storage for the command, from the factory's CommandPool
+ * @pre slot is big enough for a ReturnBook
+ * @post a new library command exists in slot
  */
-LibraryCommand* ReturnBook::create() const
+LibraryCommand* ReturnBook::create(void* slot) const
 {
-   return new ReturnBook(bookDB, patronDB);
+   return new (slot) ReturnBook(bookDB, patronDB);
 }
\ No newline at end of file
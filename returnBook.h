@@ -46,12 +46,12 @@ public:
    /** create()
     * Create Library Command (factory)
     *
-    * Create a library command of the appropriate type
-    * this function is pure virtual
-    * @pre None
-    * @post a new library command exists
+    * Create a library command of the appropriate type in slot
+    * @param slot storage for the command, from the factory's CommandPool
+    * @pre slot is big enough for a ReturnBook
+    * @post a new library command exists in slot
     */
-   virtual LibraryCommand* create() const;
+   virtual LibraryCommand* create(void* slot) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+/** @file ringBuffer.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A RingBuffer passes items from one producer thread to one consumer
+ *     thread, in order, through a fixed number of slots
+ *   - Used by Library::pipeCommands, where a parser thread hands parsed
+ *     commands to the thread executing them
+ *   - The producer closes the buffer after its last item, so the consumer
+ *     knows when to stop
+ *
+ * Implementation:
+ *   - The slots are a power of two, indexed by two counters that only grow:
+ *     the producer owns tail and the consumer owns head. Each publishes its
+ *     counter with a release store and reads the other's with an acquire
+ *     load, so no lock is taken
+ *   - tryPush and tryPop never wait, they fail when the buffer is full or
+ *     empty. waitForRoom and waitForItem wait for the other side: they spin
+ *     a few times, then park on a condition variable. A side that parks sets
+ *     a flag first, and the other side only takes the lock to wake it when
+ *     the flag is set, so the lock stays off the path while both are busy
+ *   - Only safe with exactly one producer and one consumer
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+template <class T>
+class RingBuffer
+{
+public:
+   // -------------------------------------------------------------------------
+   /** RingBuffer()
+    * Constructor
+    *
+    * @param capacity most items held at once, rounded up to a power of two
+    * @pre capacity > 0
+    * @post buffer is empty and open
+    */
+   explicit RingBuffer(size_t capacity)
+   {
+      size_t slots = 1;
+      while (slots < capacity) {
+         slots *= 2;
+      }
+      items.resize(slots);
+      mask = slots - 1;
+      head.store(0);
+      tail.store(0);
+      closed.store(false);
+      producerParked.store(false);
+      consumerParked.store(false);
+   }
+
+   // no copies, the two threads share one buffer
+   RingBuffer(const RingBuffer&) = delete;
+   RingBuffer& operator=(const RingBuffer&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** tryPush()
+    * Add an item at the back
+    *
+    * Producer only
+    * @param item the item
+    * @pre the buffer is not closed
+    * @post item is last in the buffer if there was room
+    * @return false if the buffer was full, nothing added
+    */
+   bool tryPush(const T& item)
+   {
+      size_t back = tail.load(memory_order_relaxed);
+      if (back - head.load(memory_order_acquire) > mask) {
+         return false;
+      }
+      items[back & mask] = item;
+      tail.store(back + 1, memory_order_release);
+      wake(consumerParked);
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   /** tryPop()
+    * Take the item at the front
+    *
+    * Consumer only
+    * @param item receives the item
+    * @pre None.
+    * @post the first item is removed from the buffer if there was one
+    * @return false if the buffer was empty, item unchanged
+    */
+   bool tryPop(T& item)
+   {
+      size_t front = head.load(memory_order_relaxed);
+      if (front == tail.load(memory_order_acquire)) {
+         return false;
+      }
+      item = items[front & mask];
+      head.store(front + 1, memory_order_release);
+      wake(producerParked);
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   /** close()
+    * No more items
+    *
+    * Producer only, after its last tryPush
+    * @pre None.
+    * @post isClosed() is true
+    */
+   void close()
+   {
+      closed.store(true, memory_order_release);
+      wake(consumerParked);
+   }
+
+   // -------------------------------------------------------------------------
+   /** waitForRoom()
+    * Wait until the buffer is not full
+    *
+    * Producer only, after tryPush failed
+    * @pre None.
+    * @post there was a free slot when it returned
+    */
+   void waitForRoom()
+   {
+      waitUntil(producerParked, [this] {
+         return tail.load(memory_order_relaxed) -
+                    head.load(memory_order_acquire) <=
+                mask;
+      });
+   }
+
+   // -------------------------------------------------------------------------
+   /** waitForItem()
+    * Wait until the buffer holds an item or is closed
+    *
+    * Consumer only, after tryPop failed
+    * @pre None.
+    * @post there was an item, or the buffer was closed, when it returned
+    */
+   void waitForItem()
+   {
+      waitUntil(consumerParked, [this] {
+         return head.load(memory_order_relaxed) !=
+                    tail.load(memory_order_acquire) ||
+                closed.load(memory_order_acquire);
+      });
+   }
+
+   // -------------------------------------------------------------------------
+   /** isClosed()
+    * Producer is done
+    *
+    * Items pushed before close() can still be waiting. A consumer that sees
+    * the buffer closed must try one more pop before it stops.
+    * @pre None.
+    * @post None. const
+    * @return true once close() was called
+    */
+   bool isClosed() const { return closed.load(memory_order_acquire); }
+
+   // -------------------------------------------------------------------------
+   /** getSize() / getCapacity()
+    * Items waiting and most items held
+    *
+    * getSize() is exact when called by either thread while the other is
+    * idle, and a close guess otherwise
+    */
+   size_t getSize() const
+   {
+      return tail.load(memory_order_acquire) - head.load(memory_order_acquire);
+   }
+   size_t getCapacity() const { return mask + 1; }
+
+private:
+   // times a waiting side checks again before it parks
+   static const int SPINS = 64;
+
+   // -------------------------------------------------------------------------
+   /** waitUntil()
+    * Spin, then park until ready() is true
+    *
+    * The flag is set before each check of ready() under the lock, and
+    * wake() reads it after publishing, with a full fence on both sides, so
+    * either the waiter sees the change or wake() sees the flag and
+    * notifies. wake() clears the flag, so only the first change after a
+    * park takes the lock
+    * @param parked this side's flag
+    * @param ready the condition to wait for
+    * @pre None.
+    * @post ready() was true when it returned
+    */
+   template <class Ready>
+   void waitUntil(atomic<bool>& parked, Ready ready)
+   {
+      for (int spin = 0; spin < SPINS; spin++) {
+         if (ready()) {
+            return;
+         }
+         this_thread::yield();
+      }
+      unique_lock<mutex> lock(parkLock);
+      while (true) {
+         parked.store(true, memory_order_relaxed);
+         atomic_thread_fence(memory_order_seq_cst);
+         if (ready()) {
+            break;
+         }
+         wakeUp.wait(lock);
+      }
+      parked.store(false, memory_order_relaxed);
+   }
+
+   // -------------------------------------------------------------------------
+   /** wake()
+    * Wake the other side if it is parked
+    *
+    * @param parked the other side's flag
+    * @pre the change the other side waits for is already stored
+    * @post the other side is notified, once, if it had parked
+    */
+   void wake(atomic<bool>& parked)
+   {
+      atomic_thread_fence(memory_order_seq_cst);
+      if (parked.load(memory_order_relaxed) &&
+          parked.exchange(false, memory_order_relaxed)) {
+         lock_guard<mutex> lock(parkLock);
+         wakeUp.notify_all();
+      }
+   }
+
+   // the slots, a power of two of them
+   vector<T> items;
+
+   // slots less one, to wrap a counter into an index
+   size_t mask;
+
+   // items taken and items added since the start. Kept on separate cache
+   // lines so the two threads do not slow each other down
+   alignas(64) atomic<size_t> head;
+   alignas(64) atomic<size_t> tail;
+
+   // set by the producer after its last item
+   atomic<bool> closed;
+
+   // set while a side is parked in waitUntil
+   atomic<bool> producerParked;
+   atomic<bool> consumerParked;
+
+   // what a parked side waits on
+   mutex parkLock;
+   condition_variable wakeUp;
+};
+
+#endif
@@ -0,0 +1,571 @@
+/** @file sortedTree.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Binary search tree class template holding pointers to T, ordered by a
+ *     comparator type chosen at compile time
+ *   - Can be queried to determine if empty, for its size and height
+ *   - Can empty itself
+ *   - Can insert given items and retrieve them, or find them by any key the
+ *     comparator knows how to compare against a T
+ *   - Can be visited in order, or sideways for display
+ *   - Can be converted into a sorted array and built back from one
+ *
+ * Implementation:
+ *   - Compare is a function object with int operator()(const A&, const B&)
+ *     returning negative, zero or positive, like string::compare. Because
+ *     the comparator is a template parameter the compiler can inline it,
+ *     one three-way comparison per level instead of virtual < then ==
+ *   - Optionally self-balancing (AVL) and optionally arena-backed, see
+ *     TreeOption
+ *   - The tree owns the data it points to and deletes it when emptied
+ *   - BSTree is this template instantiated for BSTData with the virtual
+ *     comparison operators
+ */
+
+#ifndef SORTEDTREE_H
+#define SORTEDTREE_H
+
+#include "arena.h"
+#include <new>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Options for how a tree arranges and allocates its nodes, combined with |
+enum TreeOption {
+   // plain unbalanced insert, the tree takes the shape of the input order
+   TREE_PLAIN = 0,
+   // AVL insert, height stays O(log n) no matter the input order
+   TREE_BALANCED = 1,
+   // nodes are carved out of an arena instead of one new per node
+   TREE_ARENA = 2
+};
+
+template <class T, class Compare>
+class SortedTree
+{
+public:
+   // -------------------------------------------------------------------------
+   /** Constructor
+    * constructor with options
+    *
+    * Creates an empty tree that inserts using the given options.
+    * @param options TreeOption values combined with |
+    * @pre None.
+    * @post tree exists. root is instantiated to NULLPTR
+    */
+   explicit SortedTree(int options)
+   {
+      root = nullptr;
+      nodeArena = nullptr;
+      balanced = (options & TREE_BALANCED) != 0;
+      if ((options & TREE_ARENA) != 0) {
+         nodeArena = new Arena<Node>();
+      }
+      size = 0;
+      height = 0;
+      lastComparisons = 0;
+      totalComparisons = 0;
+      retrieveCount = 0;
+   }
+
+   // -------------------------------------------------------------------------
+   /** Destructor
+    *
+    * Deletes every node and the data they point to.
+    * @pre None.
+    * @post tree is deleted from memory
+    */
+   ~SortedTree()
+   {
+      makeEmpty();
+      delete nodeArena;
+   }
+
+   // no copies, the tree owns its nodes and data
+   SortedTree(const SortedTree&) = delete;
+   SortedTree& operator=(const SortedTree&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** isEmpty
+    * Is the tree empty?
+    *
+    * @pre None.
+    * @post None.
+    * @return true if the tree has no nodes
+    */
+   bool isEmpty() const { return root == nullptr; }
+
+   // -------------------------------------------------------------------------
+   /** makeEmpty
+    * Make the tree empty
+    *
+    * Delete all nodes and the data they point to. In arena mode the arena
+    * is walked in order instead of the tree and the nodes are freed at once.
+    * @pre None.
+    * @post The tree is empty.
+    */
+   void makeEmpty()
+   {
+      if (nodeArena != nullptr) {
+         nodeArena->forEach([](Node* current) { delete current->data; });
+         nodeArena->releaseAll();
+      } else {
+         makeEmptyHelper(root);
+      }
+      root = nullptr;
+      size = 0;
+      height = 0;
+   }
+
+   // -------------------------------------------------------------------------
+   /** insert
+    * Insert data into tree
+    *
+    * Inserts the data into its sorted position. If equal data is already in
+    * the tree the new data is not inserted and is not deleted.
+    * @param dataptr the data to be inserted
+    * @pre dataptr can be compared with the data already in the tree
+    * @post The tree holds dataptr, unless it was a duplicate
+    * @return True if dataptr was inserted, false if it already exists
+    */
+   bool insert(T* dataptr)
+   {
+      Node* ptr = newNode(dataptr);
+
+      if (balanced) {
+         bool inserted = true;
+         root = insertBalanced(root, ptr, inserted);
+         if (!inserted) {
+            discardNode(ptr);
+            return false;
+         }
+         size++;
+         height = root->height;
+         return true;
+      }
+
+      int depth = 1;
+      if (root == nullptr) {
+         root = ptr;
+      } else {
+         Node* current = root;
+         while (true) {
+            depth++;
+            int comparison = compare(*dataptr, *current->data);
+            if (comparison == 0) {
+               discardNode(ptr);
+               return false;
+            }
+            Node*& next = comparison < 0 ? current->left : current->right;
+            if (next == nullptr) { // at leaf, insert here
+               next = ptr;
+               break;
+            }
+            current = next;
+         }
+      }
+
+      size++;
+      if (depth > height) {
+         height = depth;
+      }
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   /** find
+    * Find by key
+    *
+    * Walks one path down from the root, iteratively, using the comparator
+    * to compare key against each node's data.
+    * @param key anything Compare can compare against a T
+    * @pre None.
+    * @post None. lastComparisons holds the number of comparisons made
+    * @return the matching data, nullptr if not found
+    */
+   template <class Key>
+   T* find(const Key& key) const
+   {
+      const Node* current = root;
+      int comparisons = 0;
+      T* found = nullptr;
+
+      while (current != nullptr) {
+         comparisons++;
+         int comparison = compare(key, *current->data);
+         if (comparison == 0) {
+            found = current->data;
+            break;
+         }
+         current = comparison < 0 ? current->left : current->right;
+      }
+
+      lastComparisons = comparisons;
+      totalComparisons += comparisons;
+      retrieveCount++;
+      return found;
+   }
+
+   // -------------------------------------------------------------------------
+   /** retrieve
+    * Retrieve data
+    *
+    * Finds the data equal to toFind and returns it through found.
+    * @param toFind data equal to the data we are looking for
+    * @param found set to the data in the tree if it is found
+    * @pre None.
+    * @post found points to the data in the tree or is left unchanged
+    * @return true if the data was found, false otherwise
+    */
+   bool retrieve(const T& toFind, T*& found) const
+   {
+      T* data = find(toFind);
+      if (data == nullptr) {
+         return false;
+      }
+      found = data;
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   /** inorder
+    * Visit in sorted order
+    *
+    * Calls visit with each data pointer, smallest first. Uses an explicit
+    * stack, as do sideways and the teardown, so an unbalanced tree can be
+    * as deep as it likes.
+    * @param visit function or lambda taking a T*
+    * @pre None.
+    * @post None.
+    */
+   template <class Visit>
+   void inorder(Visit visit) const
+   {
+      vector<const Node*> path;
+      const Node* current = root;
+      while (current != nullptr || !path.empty()) {
+         while (current != nullptr) {
+            path.push_back(current);
+            current = current->left;
+         }
+         current = path.back();
+         path.pop_back();
+         visit(current->data);
+         current = current->right;
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   /** sideways
+    * Visit rotated 90 degrees
+    *
+    * Calls visit with each data pointer and its depth (root is 1), right
+    * subtree first, so printing one line per call draws the tree sideways.
+    * @param visit function or lambda taking a T* and an int depth
+    * @pre None.
+    * @post None.
+    */
+   template <class Visit>
+   void sideways(Visit visit) const
+   {
+      sidewaysHelper(root, 0, visit);
+   }
+
+   // -------------------------------------------------------------------------
+   /** arrayToTree
+    * turn array into tree
+    *
+    * Builds a perfectly balanced tree from a sorted array in linear time.
+    * Leaves the array with nullptrs.
+    * @param arr An array of T*
+    * @param count number of items in arr
+    * @pre arr holds count T* sorted by Compare with no duplicates
+    * @post The tree holds the data from the array, balanced. The old tree was
+    * deleted.
+    */
+   void arrayToTree(T* arr[], int count)
+   {
+      makeEmpty();
+      arrayToTreeHelper(arr, root, 0, count - 1);
+      size = count;
+      height = nodeHeight(root);
+   }
+
+   // -------------------------------------------------------------------------
+   /** treeToArray
+    * turn tree into array
+    *
+    * Moves the data into arr in sorted order and empties the tree. The data
+    * is not deleted, the caller now owns it.
+    * @param arr An array with room for getSize() T*
+    * @pre arr is at least getSize() long
+    * @post arr holds the data in sorted order. The tree is empty.
+    */
+   void treeToArray(T* arr[])
+   {
+      int index = 0;
+      inorder([&arr, &index](T* data) { arr[index++] = data; });
+      if (nodeArena != nullptr) {
+         nodeArena->releaseAll();
+      } else {
+         releaseNodes(root);
+      }
+      root = nullptr;
+      size = 0;
+      height = 0;
+   }
+
+   // -------------------------------------------------------------------------
+   /** getRoot()
+    * Return Root
+    *
+    * @pre tree is not empty
+    * @post None.
+    * @return the data at the root of the tree
+    */
+   const T* getRoot() const { return root->data; }
+
+   // -------------------------------------------------------------------------
+   /** getHeight() / getSize() / isBalanced()
+    * Tree shape
+    *
+    * Height is the number of nodes on the longest path from the root to a
+    * leaf, 0 for an empty tree. Size is the number of nodes.
+    */
+   int getHeight() const { return height; }
+   int getSize() const { return size; }
+   bool isBalanced() const { return balanced; }
+
+   // -------------------------------------------------------------------------
+   /** getLastComparisons() / getTotalComparisons() / getRetrieveCount()
+    * Lookup statistics
+    *
+    * Three-way comparisons made by the last find or retrieve, by all of them,
+    * and the number of finds and retrieves so far.
+    */
+   int getLastComparisons() const { return lastComparisons; }
+   long long getTotalComparisons() const { return totalComparisons; }
+   long long getRetrieveCount() const { return retrieveCount; }
+
+private:
+   // -------------------------------------------------------------------------
+   /** Node struct
+    *
+    * Points to left and right nodes and to the data it holds
+    */
+   struct Node {
+      // The data within a node
+      T* data;
+      // left subtree pointer
+      Node* left;
+      // right subtree pointer
+      Node* right;
+      // nodes on the longest path down from this node, a leaf is 1
+      int height;
+   };
+
+   // the root of the tree
+   Node* root;
+
+   // where nodes come from in TREE_ARENA mode, nullptr otherwise
+   Arena<Node>* nodeArena;
+
+   // true when insert keeps the tree AVL balanced
+   bool balanced;
+
+   // number of nodes and height of the whole tree
+   int size;
+   int height;
+
+   // the ordering of the tree
+   Compare compare;
+
+   // lookup statistics, updated by the const find
+   mutable int lastComparisons;
+   mutable long long totalComparisons;
+   mutable long long retrieveCount;
+
+   // make a leaf node, from the arena if the tree has one
+   Node* newNode(T* dataptr)
+   {
+      Node* ptr = nodeArena != nullptr ? new (nodeArena->allocate()) Node
+                                       : new Node;
+      ptr->data = dataptr;
+      ptr->left = ptr->right = nullptr;
+      ptr->height = 1;
+      return ptr;
+   }
+
+   // free the node made by the most recent newNode, it never got linked in
+   void discardNode(Node* ptr)
+   {
+      if (nodeArena != nullptr) {
+         nodeArena->unallocate(ptr);
+      } else {
+         delete ptr;
+      }
+   }
+
+   // delete of nodes and data, used without an arena. Uses an explicit
+   // stack, like inorder
+   void makeEmptyHelper(Node* current)
+   {
+      vector<Node*> pending;
+      if (current != nullptr) {
+         pending.push_back(current);
+      }
+      while (!pending.empty()) {
+         current = pending.back();
+         pending.pop_back();
+         if (current->left != nullptr) {
+            pending.push_back(current->left);
+         }
+         if (current->right != nullptr) {
+            pending.push_back(current->right);
+         }
+         delete current->data;
+         delete current;
+      }
+   }
+
+   // delete of nodes only, the data has been handed out
+   void releaseNodes(Node* current)
+   {
+      vector<Node*> pending;
+      if (current != nullptr) {
+         pending.push_back(current);
+      }
+      while (!pending.empty()) {
+         current = pending.back();
+         pending.pop_back();
+         if (current->left != nullptr) {
+            pending.push_back(current->left);
+         }
+         if (current->right != nullptr) {
+            pending.push_back(current->right);
+         }
+         delete current;
+      }
+   }
+
+   // AVL insert of ptr below current, returns the new subtree root
+   Node* insertBalanced(Node* current, Node* ptr, bool& inserted)
+   {
+      if (current == nullptr) {
+         return ptr;
+      }
+
+      int comparison = compare(*ptr->data, *current->data);
+      if (comparison == 0) {
+         inserted = false;
+         return current;
+      }
+      if (comparison < 0) {
+         current->left = insertBalanced(current->left, ptr, inserted);
+      } else {
+         current->right = insertBalanced(current->right, ptr, inserted);
+      }
+
+      if (!inserted) {
+         return current; // nothing below changed
+      }
+      return rebalance(current);
+   }
+
+   // fix the height of current and rotate if its subtrees differ by 2
+   Node* rebalance(Node* current)
+   {
+      updateHeight(current);
+      int balance = nodeHeight(current->left) - nodeHeight(current->right);
+
+      if (balance > 1) { // left heavy
+         if (nodeHeight(current->left->left) <
+             nodeHeight(current->left->right)) {
+            current->left = rotateLeft(current->left); // left-right case
+         }
+         return rotateRight(current);
+      }
+      if (balance < -1) { // right heavy
+         if (nodeHeight(current->right->right) <
+             nodeHeight(current->right->left)) {
+            current->right = rotateRight(current->right); // right-left case
+         }
+         return rotateLeft(current);
+      }
+      return current;
+   }
+
+   // right child becomes the root of the subtree
+   Node* rotateLeft(Node* current)
+   {
+      Node* newRoot = current->right;
+      current->right = newRoot->left;
+      newRoot->left = current;
+      updateHeight(current);
+      updateHeight(newRoot);
+      return newRoot;
+   }
+
+   // left child becomes the root of the subtree
+   Node* rotateRight(Node* current)
+   {
+      Node* newRoot = current->left;
+      current->left = newRoot->right;
+      newRoot->right = current;
+      updateHeight(current);
+      updateHeight(newRoot);
+      return newRoot;
+   }
+
+   // height of a subtree, 0 for nullptr
+   static int nodeHeight(const Node* current)
+   {
+      return current == nullptr ? 0 : current->height;
+   }
+
+   // one more than the taller child
+   static void updateHeight(Node* current)
+   {
+      int left = nodeHeight(current->left);
+      int right = nodeHeight(current->right);
+      current->height = 1 + (left > right ? left : right);
+   }
+
+   // middle of arr[start..end] becomes current, halves become its subtrees
+   void arrayToTreeHelper(T* arr[], Node*& current, int start, int end)
+   {
+      if (end < start) {
+         return;
+      }
+      int currentIndex = (start + end) / 2;
+      current = newNode(arr[currentIndex]);
+      arr[currentIndex] = nullptr;
+      arrayToTreeHelper(arr, current->left, start, currentIndex - 1);
+      arrayToTreeHelper(arr, current->right, currentIndex + 1, end);
+      updateHeight(current);
+   }
+
+   // reverse inorder walk that passes each node's depth, with an explicit
+   // stack of nodes and their depths
+   template <class Visit>
+   void sidewaysHelper(const Node* current, int level, Visit& visit) const
+   {
+      vector<pair<const Node*, int>> path;
+      while (current != nullptr || !path.empty()) {
+         while (current != nullptr) {
+            path.push_back({current, ++level});
+            current = current->right;
+         }
+         current = path.back().first;
+         level = path.back().second;
+         path.pop_back();
+         visit(current->data, level);
+         current = current->left;
+      }
+   }
+};
+
+#endif
@@ -0,0 +1,213 @@
+/** @file stringPool.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A StringPool keeps one copy of each distinct string handed to it and
+ *     gives back a string_view of that copy
+ *   - Used by BookFactory for the author and title of every book, so an
+ *     author with many books, or a periodical with many issues, stores its
+ *     text once
+ *   - Two views from the same pool are equal strings exactly when they
+ *     point at the same bytes, so equality is a pointer comparison
+ *
+ * Implementation:
+ *   - The text is copied into large blocks that are never moved or freed
+ *     until the pool is destroyed, so every view stays valid that long
+ *   - Split into shards by hash, each with its own lock, its own blocks and
+ *     its own hash table, so threads parsing books in parallel rarely wait
+ *     on each other
+ *   - The tables use open addressing with linear probing and keep each
+ *     string's hash, so a string is hashed once and a probe only compares
+ *     text when the hashes match
+ *   - Counts the bytes asked for and the bytes stored, so the saving can be
+ *     reported
+ */
+
+#include "stringPool.h"
+#include <cstring>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+// -------------------------------------------------------------------------
+/** StringPool()
+ * Default Constructor
+ *
+ * Nothing is allocated until the first string is interned
+ * @pre None.
+ * @post pool is empty
+ */
+StringPool::StringPool() {}
+
+// -------------------------------------------------------------------------
+/** ~StringPool()
+ * Destructor
+ *
+ * Frees every block. Views handed out become invalid.
+ * @pre None.
+ * @post pool is empty
+ */
+StringPool::~StringPool()
+{
+   for (Shard& shard : shards) {
+      for (char* block : shard.blocks) {
+         delete[] block;
+      }
+      for (char* block : shard.large) {
+         delete[] block;
+      }
+   }
+}
+
+// -------------------------------------------------------------------------
+/** intern()
+ * Pooled copy of a string
+ *
+ * Safe to call from several threads at once
+ * @param text the string, need not outlive the call
+ * @pre None.
+ * @post the pool holds a copy of text
+ * @return view of the pool's copy, valid while the pool lives. Empty
+ * text always gives the same empty view.
+ */
+string_view StringPool::intern(string_view text)
+{
+   if (text.empty()) {
+      return string_view();
+   }
+
+   uint64_t hash = std::hash<string_view>()(text);
+   Shard& shard = shards[(hash >> 56) & (SHARD_COUNT - 1)];
+   lock_guard<mutex> guard(shard.lock);
+   shard.interned++;
+   shard.requested += text.size();
+
+   if ((shard.count + 1) * 2 > shard.table.size()) {
+      grow(shard);
+   }
+   size_t mask = shard.table.size() - 1;
+   size_t index = hash & mask;
+   while (shard.table[index].text != nullptr) {
+      const Slot& slot = shard.table[index];
+      if (slot.hash == hash && slot.length == text.size() &&
+          memcmp(slot.text, text.data(), text.size()) == 0) {
+         return string_view(slot.text, slot.length);
+      }
+      index = (index + 1) & mask;
+   }
+
+   string_view copy = store(shard, text);
+   shard.table[index] = Slot{hash, copy.data(), copy.size()};
+   shard.count++;
+   return copy;
+}
+
+// -------------------------------------------------------------------------
+/** getInternCount() / getUniqueCount()
+ * Strings interned
+ *
+ * getInternCount() is the number of intern calls with non-empty text,
+ * getUniqueCount() the number of distinct strings stored
+ */
+long long StringPool::getInternCount() const
+{
+   long long total = 0;
+   for (const Shard& shard : shards) {
+      lock_guard<mutex> guard(shard.lock);
+      total += shard.interned;
+   }
+   return total;
+}
+
+long long StringPool::getUniqueCount() const
+{
+   long long total = 0;
+   for (const Shard& shard : shards) {
+      lock_guard<mutex> guard(shard.lock);
+      total += shard.count;
+   }
+   return total;
+}
+
+// -------------------------------------------------------------------------
+/** getStoredBytes() / getSavedBytes()
+ * Bytes of text
+ *
+ * getStoredBytes() is the text held by the pool. getSavedBytes() is the
+ * text that was asked for again and shared instead of copied.
+ */
+long long StringPool::getStoredBytes() const
+{
+   long long total = 0;
+   for (const Shard& shard : shards) {
+      lock_guard<mutex> guard(shard.lock);
+      total += shard.stored;
+   }
+   return total;
+}
+
+long long StringPool::getSavedBytes() const
+{
+   long long total = 0;
+   for (const Shard& shard : shards) {
+      lock_guard<mutex> guard(shard.lock);
+      total += shard.requested - shard.stored;
+   }
+   return total;
+}
+
+// -------------------------------------------------------------------------
+/** store()
+ * Copy text into a shard's blocks
+ *
+ * @param shard the shard, locked by the caller
+ * @param text the string
+ * @pre shard.lock is held
+ * @post the shard's blocks hold a copy of text
+ * @return view of the copy
+ */
+string_view StringPool::store(Shard& shard, string_view text)
+{
+   char* copy;
+   if (text.size() > BLOCK_SIZE / 4) {
+      copy = new char[text.size()];
+      shard.large.push_back(copy);
+   } else {
+      if (shard.blocks.empty() || shard.used + text.size() > BLOCK_SIZE) {
+         shard.blocks.push_back(new char[BLOCK_SIZE]);
+         shard.used = 0;
+      }
+      copy = shard.blocks.back() + shard.used;
+      shard.used += text.size();
+   }
+   memcpy(copy, text.data(), text.size());
+   shard.stored += text.size();
+   return string_view(copy, text.size());
+}
+
+// -------------------------------------------------------------------------
+/** grow()
+ * Double a shard's table
+ *
+ * @param shard the shard, locked by the caller
+ * @pre shard.lock is held
+ * @post the table is twice as big and holds the same strings
+ */
+void StringPool::grow(Shard& shard)
+{
+   vector<Slot> old(shard.table.empty() ? MIN_TABLE : shard.table.size() * 2,
+                    Slot{0, nullptr, 0});
+   swap(old, shard.table);
+   size_t mask = shard.table.size() - 1;
+   for (const Slot& slot : old) {
+      if (slot.text == nullptr) {
+         continue;
+      }
+      size_t index = slot.hash & mask;
+      while (shard.table[index].text != nullptr) {
+         index = (index + 1) & mask;
+      }
+      shard.table[index] = slot;
+   }
+}
@@ -0,0 +1,165 @@
+/** @file stringPool.h
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - A StringPool keeps one copy of each distinct string handed to it and
+ *     gives back a string_view of that copy
+ *   - Used by BookFactory for the author and title of every book, so an
+ *     author with many books, or a periodical with many issues, stores its
+ *     text once
+ *   - Two views from the same pool are equal strings exactly when they
+ *     point at the same bytes, so equality is a pointer comparison
+ *
+ * Implementation:
+ *   - The text is copied into large blocks that are never moved or freed
+ *     until the pool is destroyed, so every view stays valid that long
+ *   - Split into shards by hash, each with its own lock, its own blocks and
+ *     its own hash table, so threads parsing books in parallel rarely wait
+ *     on each other
+ *   - The tables use open addressing with linear probing and keep each
+ *     string's hash, so a string is hashed once and a probe only compares
+ *     text when the hashes match
+ *   - Counts the bytes asked for and the bytes stored, so the saving can be
+ *     reported
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class StringPool
+{
+public:
+   // -------------------------------------------------------------------------
+   /** StringPool()
+    * Default Constructor
+    *
+    * Nothing is allocated until the first string is interned
+    * @pre None.
+    * @post pool is empty
+    */
+   StringPool();
+
+   // -------------------------------------------------------------------------
+   /** ~StringPool()
+    * Destructor
+    *
+    * Frees every block. Views handed out become invalid.
+    * @pre None.
+    * @post pool is empty
+    */
+   ~StringPool();
+
+   // no copies, views point into the pool's own blocks
+   StringPool(const StringPool&) = delete;
+   StringPool& operator=(const StringPool&) = delete;
+
+   // -------------------------------------------------------------------------
+   /** intern()
+    * Pooled copy of a string
+    *
+    * Safe to call from several threads at once
+    * @param text the string, need not outlive the call
+    * @pre None.
+    * @post the pool holds a copy of text
+    * @return view of the pool's copy, valid while the pool lives. Empty
+    * text always gives the same empty view.
+    */
+   string_view intern(string_view text);
+
+   // -------------------------------------------------------------------------
+   /** getInternCount() / getUniqueCount()
+    * Strings interned
+    *
+    * getInternCount() is the number of intern calls with non-empty text,
+    * getUniqueCount() the number of distinct strings stored
+    */
+   long long getInternCount() const;
+   long long getUniqueCount() const;
+
+   // -------------------------------------------------------------------------
+   /** getStoredBytes() / getSavedBytes()
+    * Bytes of text
+    *
+    * getStoredBytes() is the text held by the pool. getSavedBytes() is the
+    * text that was asked for again and shared instead of copied.
+    */
+   long long getStoredBytes() const;
+   long long getSavedBytes() const;
+
+private:
+   // number of shards, a power of two
+   static const size_t SHARD_COUNT = 16;
+
+   // slots in a shard's table when the first string is stored
+   static const size_t MIN_TABLE = 64;
+
+   // bytes in one block. Strings over a quarter of it are allocated alone
+   static const size_t BLOCK_SIZE = 64 * 1024;
+
+   // a stored string and its hash, or an empty slot if text is nullptr
+   struct Slot {
+      uint64_t hash;
+      const char* text;
+      size_t length;
+   };
+
+   // one lock with the strings it guards
+   struct Shard {
+      mutable mutex lock;
+
+      // open addressing table of every string stored in this shard. Its
+      // size is a power of two and it is never more than half full
+      vector<Slot> table;
+
+      // strings in the table
+      size_t count = 0;
+
+      // storage, the last block is the one being filled
+      vector<char*> blocks;
+
+      // bytes used in the last block
+      size_t used = 0;
+
+      // strings too long for a block, one allocation each
+      vector<char*> large;
+
+      // intern calls and bytes asked for, bytes stored
+      long long interned = 0;
+      long long requested = 0;
+      long long stored = 0;
+   };
+
+   Shard shards[SHARD_COUNT];
+
+   // -------------------------------------------------------------------------
+   /** grow()
+    * Double a shard's table
+    *
+    * @param shard the shard, locked by the caller
+    * @pre shard.lock is held
+    * @post the table is twice as big and holds the same strings
+    */
+   static void grow(Shard& shard);
+
+   // -------------------------------------------------------------------------
+   /** store()
+    * Copy text into a shard's blocks
+    *
+    * @param shard the shard, locked by the caller
+    * @param text the string
+    * @pre shard.lock is held
+    * @post the shard's blocks hold a copy of text
+    * @return view of the copy
+    */
+   static string_view store(Shard& shard, string_view text);
+};
+
+#endif
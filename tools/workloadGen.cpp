@@ -0,0 +1,603 @@
+/** @file workloadGen.cpp
+ * @author Joseph Collora and Josh Helzerman
+ *
+ * Description:
+ *   - Writes a book file, a patron file and a command file of any size in
+ *     the formats the library reads: data4books.txt, data4patrons.txt and
+ *     data4commands.txt, ready to run main or a benchmark on
+ *   - Every line is valid. Commands can still fail the way real ones do,
+ *     a checkout of a book with no copies left or a return of a book the
+ *     patron does not have
+ *   - The same options and seed always give the same files, on any
+ *     platform, so a performance change can be measured on the same input
+ *     before and after
+ *
+ * Implementation:
+ *   - Authors and titles are built from word lists, and made unique by a
+ *     number where needed. Periodicals are a set of magazines, each with an
+ *     issue per month over a run of years
+ *   - --sorted is the fraction of books left in the order the catalog sorts
+ *     them in (BookCompare). At 1 the file is fully sorted and inserting it
+ *     one book at a time builds the degenerate BST shape, at 0 it is fully
+ *     shuffled. In between, the books not kept in place are shuffled among
+ *     their own positions
+ *   - Books checked out are picked by a Zipf distribution over a random
+ *     popularity ranking, so a few titles get most of the checkouts, and
+ *     checkouts of the popular ones fail once their copies are all out. A
+ *     return is of a book the patron has out when there is one
+ *   - Random numbers come from mt19937_64 with our own range reduction and
+ *     shuffle, since the standard distributions differ between libraries
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++17 -O2 -I. tools/workloadGen.cpp -o workloadGen
+ *   ./workloadGen --books=1000000 --patrons=5000 --commands=10000000 \
+ *       --mix=50:45:0:5 --zipf=1.0 --sorted=0 --seed=1 --out=big
+ *
+ * Options, all optional:
+ *   --books=N         catalog lines (default 10000)
+ *   --types=F:C:P     share of fiction, children and periodicals (60:30:10)
+ *   --sorted=S        fraction of books in catalog order, 0 to 1 (0)
+ *   --zipf=T          popularity skew of checkouts, 0 is uniform (1.0)
+ *   --patrons=N       patrons, at most 10000 (1000)
+ *   --commands=N      command lines (100000)
+ *   --mix=C:R:D:H     share of checkout, return, display library and
+ *                     display patron commands (50:45:0.01:5)
+ *   --seed=N          seed of the random numbers (1)
+ *   --out=DIR         directory the three files are written to (.)
+ */
+
+#include "constants.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+/** Options
+ *
+ * Every setting of the generator, from the command line
+ */
+// -----------------------------------------------------------------------------
+struct Options {
+   long long books = 10000;
+   double typeShare[3] = {60, 30, 10};
+   double sorted = 0;
+   double zipf = 1.0;
+   int patrons = 1000;
+   long long commands = 100000;
+   double commandShare[4] = {50, 45, 0.01, 5};
+   uint64_t seed = 1;
+   string out = ".";
+};
+
+// -----------------------------------------------------------------------------
+/** Random
+ *
+ * mt19937_64 with range reduction and shuffle done here, so the numbers
+ * drawn for a seed are the same with every standard library
+ */
+// -----------------------------------------------------------------------------
+class Random
+{
+public:
+   explicit Random(uint64_t seed) : engine(seed) {}
+
+   // a number from 0 to n - 1
+   uint64_t below(uint64_t n) { return n == 0 ? 0 : engine() % n; }
+
+   // a number from 0 up to but not including 1
+   double unit() { return (engine() >> 11) * (1.0 / 9007199254740992.0); }
+
+   // Fisher-Yates shuffle of items
+   template <class T>
+   void shuffle(vector<T>& items)
+   {
+      for (size_t i = items.size(); i > 1; i--) {
+         swap(items[i - 1], items[below(i)]);
+      }
+   }
+
+private:
+   mt19937_64 engine;
+};
+
+// -----------------------------------------------------------------------------
+/** Book
+ *
+ * One generated book, with the fields of its book line
+ */
+// -----------------------------------------------------------------------------
+struct Book {
+   char type;
+   string author;
+   string title;
+   int year;
+   int month;
+};
+
+// words titles are made of
+static const char* TITLE_WORDS[] = {
+    "Night",  "River",   "Stone",  "Glass",   "Moon",    "Owl",    "Iron",
+    "Sun",    "Fox",     "Shadow", "Garden",  "Winter",  "Summer", "House",
+    "Road",   "Sea",     "Storm",  "Silver",  "Golden",  "Last",   "First",
+    "Secret", "Lost",    "Hidden", "Wild",    "Quiet",   "Broken", "Little",
+    "Dream",  "Journey", "Island", "Mountain", "Forest", "City",   "Song",
+    "Letter", "Promise", "Fire",   "Water",   "Light",   "Dark",   "Blue",
+    "Red",    "Green",   "King",   "Queen",   "Child",   "Friend", "War",
+    "Peace",  "Time",    "Star",   "Wind",    "Bridge",  "Tower",  "Door"};
+
+// surnames and given names authors are made of
+static const char* LAST_NAMES[] = {
+    "Smith",   "Muller",  "Garcia",  "Chen",    "Okafor", "Novak",
+    "Kowalski", "Tanaka", "Silva",   "Rossi",   "Dubois", "Jensen",
+    "Murphy",  "Kim",     "Nguyen",  "Patel",   "Cohen",  "Walker",
+    "Wright",  "Lobel",   "Seuss",   "Daheim",  "Forster", "Kerouac",
+    "Tolkien", "Heide",   "Ahmed",   "Ivanova", "Larsen", "Moreau"};
+static const char* FIRST_NAMES[] = {
+    "Mary",  "Jay",   "Alice",  "Arnold", "Emma",  "Richard", "Jack",
+    "Anna",  "Marcia", "Louis", "Sofia",  "Omar",  "Lena",    "Hugo",
+    "Priya", "Kenji", "Ines",   "Tomas",  "Nora",  "Felix"};
+
+// magazine names periodical issues are made of
+static const char* MAGAZINE_WORDS[] = {
+    "Communications", "Review",  "Journal", "Times",   "Digest",
+    "Quarterly",      "Monthly", "Science", "Gardens", "Travel",
+    "Kitchen",        "Motors",  "Music",   "History", "Nature"};
+
+template <class T, size_t N>
+static size_t countOf(T (&)[N])
+{
+   return N;
+}
+
+// -----------------------------------------------------------------------------
+/** parseShares()
+ * Read a list of shares such as 60:30:10
+ *
+ * @param text the list
+ * @param shares receives the shares
+ * @param count number of shares expected
+ * @return false if the list has the wrong number of shares or a negative
+ */
+bool parseShares(const string& text, double* shares, int count)
+{
+   stringstream in(text);
+   string part;
+   int found = 0;
+   while (getline(in, part, ':')) {
+      if (found == count) {
+         return false;
+      }
+      shares[found] = atof(part.c_str());
+      if (shares[found] < 0) {
+         return false;
+      }
+      found++;
+   }
+   return found == count;
+}
+
+// -----------------------------------------------------------------------------
+/** parseOptions()
+ * Read the command line
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param options receives the settings
+ * @return false if an option is unknown or out of range
+ */
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+   for (int i = 1; i < argc; i++) {
+      string arg = argv[i];
+      size_t equals = arg.find('=');
+      if (arg.rfind("--", 0) != 0 || equals == string::npos) {
+         cerr << "bad option " << arg << '\n';
+         return false;
+      }
+      string name = arg.substr(2, equals - 2);
+      string value = arg.substr(equals + 1);
+      bool ok = true;
+      if (name == "books") {
+         options.books = atoll(value.c_str());
+         ok = options.books >= 0;
+      } else if (name == "types") {
+         ok = parseShares(value, options.typeShare, 3);
+      } else if (name == "sorted") {
+         options.sorted = atof(value.c_str());
+         ok = options.sorted >= 0 && options.sorted <= 1;
+      } else if (name == "zipf") {
+         options.zipf = atof(value.c_str());
+         ok = options.zipf >= 0;
+      } else if (name == "patrons") {
+         options.patrons = atoi(value.c_str());
+         ok = options.patrons > 0 && options.patrons <= PATRON_TABLE_SIZE;
+      } else if (name == "commands") {
+         options.commands = atoll(value.c_str());
+         ok = options.commands >= 0;
+      } else if (name == "mix") {
+         ok = parseShares(value, options.commandShare, 4);
+      } else if (name == "seed") {
+         options.seed = strtoull(value.c_str(), nullptr, 10);
+      } else if (name == "out") {
+         options.out = value;
+      } else {
+         ok = false;
+      }
+      if (!ok) {
+         cerr << "bad option " << arg << '\n';
+         return false;
+      }
+   }
+   return true;
+}
+
+// -----------------------------------------------------------------------------
+/** pick()
+ * Choose by shares
+ *
+ * @param random the random numbers
+ * @param shares the weight of each choice
+ * @param count number of choices
+ * @return index of the choice
+ */
+int pick(Random& random, const double* shares, int count)
+{
+   double total = 0;
+   for (int i = 0; i < count; i++) {
+      total += shares[i];
+   }
+   double point = random.unit() * total;
+   for (int i = 0; i < count - 1; i++) {
+      if (point < shares[i]) {
+         return i;
+      }
+      point -= shares[i];
+   }
+   return count - 1;
+}
+
+// -----------------------------------------------------------------------------
+/** makeTitle()
+ * A title of one to four words
+ *
+ * @param random the random numbers
+ * @return the title, short enough to display whole
+ */
+string makeTitle(Random& random)
+{
+   string title = "The";
+   int words = 1 + (int)random.below(4);
+   for (int i = 0; i < words; i++) {
+      title += ' ';
+      title += TITLE_WORDS[random.below(countOf(TITLE_WORDS))];
+   }
+   return title;
+}
+
+// -----------------------------------------------------------------------------
+/** makeAuthor()
+ * An author, surname first like the book files
+ *
+ * @param random the random numbers
+ * @param authors how many different authors there are
+ * @return the author
+ */
+string makeAuthor(Random& random, long long authors)
+{
+   long long number = random.below(authors);
+   string author = LAST_NAMES[number % countOf(LAST_NAMES)];
+   author += ' ';
+   author += FIRST_NAMES[number / countOf(LAST_NAMES) % countOf(FIRST_NAMES)];
+   long long group = number / (countOf(LAST_NAMES) * countOf(FIRST_NAMES));
+   if (group > 0) {
+      author += ' ' + to_string(group);
+   }
+   return author;
+}
+
+// -----------------------------------------------------------------------------
+/** makeBooks()
+ * Generate the catalog
+ *
+ * Fiction and children's books are unique by author and title, periodical
+ * issues by title, month and year
+ * @param options the settings
+ * @param random the random numbers
+ * @return the books, in no particular order
+ */
+vector<Book> makeBooks(const Options& options, Random& random)
+{
+   long long counts[3] = {0, 0, 0};
+   for (long long i = 0; i < options.books; i++) {
+      counts[pick(random, options.typeShare, 3)]++;
+   }
+
+   vector<Book> books;
+   books.reserve(options.books);
+   // an author writes about eight books on average
+   long long authors = max(1LL, (counts[0] + counts[1]) / 8);
+   const char types[2] = {FICTION_CODE, CHILDREN_CODE};
+   for (int t = 0; t < 2; t++) {
+      set<pair<string, string>> used;
+      for (long long i = 0; i < counts[t]; i++) {
+         Book book{types[t], makeAuthor(random, authors), makeTitle(random),
+                   1900 + (int)random.below(125), 0};
+         while (!used.insert({book.author, book.title}).second) {
+            book.title += ' ' + to_string(random.below(1000));
+         }
+         books.push_back(book);
+      }
+   }
+
+   // each magazine has an issue every month from its first year on
+   const int YEARS = 20;
+   long long magazines = (counts[2] + 12 * YEARS - 1) / (12 * YEARS);
+   for (long long i = 0; i < counts[2]; i++) {
+      long long magazine = i % max(1LL, magazines);
+      long long issue = i / max(1LL, magazines);
+      string title = MAGAZINE_WORDS[magazine % countOf(MAGAZINE_WORDS)];
+      if (magazine >= (long long)countOf(MAGAZINE_WORDS)) {
+         title += ' ' + to_string(magazine / countOf(MAGAZINE_WORDS));
+      }
+      books.push_back(Book{PERIODICAL_CODE, "", title,
+                           2000 + (int)(issue / 12), 1 + (int)(issue % 12)});
+   }
+   return books;
+}
+
+// -----------------------------------------------------------------------------
+/** catalogLess()
+ * Catalog order
+ *
+ * The order BookCompare puts books of one type in: fiction by author then
+ * title, children's by title then author, periodicals by year, month and
+ * title. Types are kept apart.
+ */
+bool catalogLess(const Book& left, const Book& right)
+{
+   if (left.type != right.type) {
+      return left.type < right.type;
+   }
+   if (left.type == FICTION_CODE) {
+      return make_pair(left.author, left.title) <
+             make_pair(right.author, right.title);
+   }
+   if (left.type == CHILDREN_CODE) {
+      return make_pair(left.title, left.author) <
+             make_pair(right.title, right.author);
+   }
+   return make_tuple(left.year, left.month, left.title) <
+          make_tuple(right.year, right.month, right.title);
+}
+
+// -----------------------------------------------------------------------------
+/** orderBooks()
+ * Put the catalog in file order
+ *
+ * Sorts the books, deals the types out in turn so they are mixed like a
+ * real file, then shuffles every book not kept in place among the
+ * positions of those books
+ * @param books the catalog, reordered in place
+ * @param sorted fraction of books kept in catalog order
+ * @param random the random numbers
+ */
+void orderBooks(vector<Book>& books, double sorted, Random& random)
+{
+   sort(books.begin(), books.end(), catalogLess);
+
+   // each type's books stay in order, a type is chosen by what is left
+   vector<size_t> next;
+   vector<size_t> end;
+   for (size_t i = 0; i < books.size(); i++) {
+      if (i == 0 || books[i].type != books[i - 1].type) {
+         next.push_back(i);
+         if (i > 0) {
+            end.push_back(i);
+         }
+      }
+   }
+   end.push_back(books.size());
+   vector<Book> dealt;
+   dealt.reserve(books.size());
+   while (dealt.size() < books.size()) {
+      size_t left = books.size() - dealt.size();
+      size_t point = random.below(left);
+      for (size_t t = 0; t < next.size(); t++) {
+         size_t remaining = end[t] - next[t];
+         if (point < remaining) {
+            dealt.push_back(move(books[next[t]++]));
+            break;
+         }
+         point -= remaining;
+      }
+   }
+   books.swap(dealt);
+
+   vector<size_t> moved;
+   for (size_t i = 0; i < books.size(); i++) {
+      if (random.unit() >= sorted) {
+         moved.push_back(i);
+      }
+   }
+   vector<size_t> targets = moved;
+   random.shuffle(targets);
+   vector<Book> picked;
+   picked.reserve(moved.size());
+   for (size_t i : moved) {
+      picked.push_back(move(books[i]));
+   }
+   for (size_t i = 0; i < targets.size(); i++) {
+      books[targets[i]] = move(picked[i]);
+   }
+}
+
+// -----------------------------------------------------------------------------
+/** bookLine() / keyLine()
+ * A book as written in the book file, and as a command names it
+ */
+string bookLine(const Book& book)
+{
+   string line(1, book.type);
+   if (book.type == PERIODICAL_CODE) {
+      line += ' ' + book.title + ", " + to_string(book.month) + ' ' +
+              to_string(book.year);
+   } else {
+      line += ' ' + book.author + ", " + book.title + ", " +
+              to_string(book.year);
+   }
+   return line;
+}
+
+string keyLine(const Book& book)
+{
+   string line(1, book.type);
+   line += " H ";
+   if (book.type == FICTION_CODE) {
+      line += book.author + ", " + book.title + ',';
+   } else if (book.type == CHILDREN_CODE) {
+      line += book.title + ", " + book.author + ',';
+   } else {
+      line += to_string(book.year) + ' ' + to_string(book.month) + ' ' +
+              book.title + ',';
+   }
+   return line;
+}
+
+// -----------------------------------------------------------------------------
+/** Zipf
+ *
+ * Draws ranks 0 to n - 1 with probability proportional to 1 / (rank+1)^theta
+ */
+// -----------------------------------------------------------------------------
+class Zipf
+{
+public:
+   Zipf(size_t n, double theta)
+   {
+      cumulative.resize(n);
+      double total = 0;
+      for (size_t i = 0; i < n; i++) {
+         total += 1.0 / pow((double)(i + 1), theta);
+         cumulative[i] = total;
+      }
+   }
+
+   size_t draw(Random& random) const
+   {
+      double point = random.unit() * cumulative.back();
+      size_t rank =
+          upper_bound(cumulative.begin(), cumulative.end(), point) -
+          cumulative.begin();
+      return min(rank, cumulative.size() - 1);
+   }
+
+private:
+   vector<double> cumulative;
+};
+
+int main(int argc, char* argv[])
+{
+   Options options;
+   if (!parseOptions(argc, argv, options)) {
+      return 1;
+   }
+   Random random(options.seed);
+
+   vector<Book> books = makeBooks(options, random);
+   orderBooks(books, options.sorted, random);
+
+   ofstream bookFile(options.out + "/data4books.txt");
+   ofstream patronFile(options.out + "/data4patrons.txt");
+   ofstream commandFile(options.out + "/data4commands.txt");
+   if (!bookFile || !patronFile || !commandFile) {
+      cerr << "cannot write to " << options.out << '\n';
+      return 1;
+   }
+   for (const Book& book : books) {
+      bookFile << bookLine(book) << '\n';
+   }
+
+   // distinct IDs out of every four digit number
+   vector<int> ids(PATRON_TABLE_SIZE);
+   for (int i = 0; i < PATRON_TABLE_SIZE; i++) {
+      ids[i] = i;
+   }
+   random.shuffle(ids);
+   ids.resize(options.patrons);
+   vector<string> patronIDs;
+   for (int id : ids) {
+      char text[PATRON_ID_LENGTH + 1];
+      snprintf(text, sizeof(text), "%0*d", PATRON_ID_LENGTH, id);
+      patronIDs.push_back(text);
+      patronFile << text << ' ' << LAST_NAMES[random.below(countOf(LAST_NAMES))]
+                 << ' ' << FIRST_NAMES[random.below(countOf(FIRST_NAMES))]
+                 << '\n';
+   }
+
+   // popularity: rank r is the book at popular[r]
+   vector<size_t> popular(books.size());
+   for (size_t i = 0; i < popular.size(); i++) {
+      popular[i] = i;
+   }
+   random.shuffle(popular);
+   Zipf popularity(max((size_t)1, books.size()), options.zipf);
+
+   // books each patron has out, by position in books, and copies of each
+   // book on the shelf, so a return is of a checkout that succeeded
+   vector<vector<size_t>> held(options.patrons);
+   vector<int> available(books.size());
+   for (size_t i = 0; i < books.size(); i++) {
+      available[i] = books[i].type == PERIODICAL_CODE ? 1 : 5;
+   }
+   string line;
+   for (long long n = 0; n < options.commands; n++) {
+      int kind = pick(random, options.commandShare, 4);
+      if (books.empty() && (kind == 0 || kind == 1)) {
+         kind = 2;
+      }
+      int patron = (int)random.below(options.patrons);
+      vector<size_t>& out = held[patron];
+      if (kind == 0) {
+         size_t book = popular[popularity.draw(random)];
+         if (available[book] > 0) {
+            available[book]--;
+            out.push_back(book);
+         }
+         line = "C " + patronIDs[patron] + ' ' + keyLine(books[book]);
+      } else if (kind == 1) {
+         size_t book;
+         if (out.empty()) {
+            book = popular[popularity.draw(random)];
+         } else {
+            size_t index = random.below(out.size());
+            book = out[index];
+            out[index] = out.back();
+            out.pop_back();
+            available[book]++;
+         }
+         line = "R " + patronIDs[patron] + ' ' + keyLine(books[book]);
+      } else if (kind == 2) {
+         line = "D";
+      } else {
+         line = "H " + patronIDs[patron];
+      }
+      commandFile << line << '\n';
+   }
+
+   cerr << books.size() << " books, " << options.patrons << " patrons, "
+        << options.commands << " commands written to " << options.out
+        << '\n';
+   return 0;
+}